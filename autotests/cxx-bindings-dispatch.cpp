@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+// SPDX-License-Identifier: MIT
+
+/*
+ * Checks the generated C++ bindings against libwayland-client: events written
+ * on the wire are dispatched through the static listener to the on_ handlers of
+ * a binding, and typed requests are marshalled with the values of their enums.
+ * The other end of the connection is a plain socket, no compositor is needed.
+ */
+
+#include "text-input-unstable-v2-client-bindings.h"
+
+#include <wayland-client.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace PlasmaWaylandProtocols::Client;
+
+namespace
+{
+
+struct TextInput : ZwpTextInputV2<TextInput> {
+    void on_commit_string(std::string_view text)
+    {
+        commitString = std::string(text);
+    }
+
+    void on_text_direction(TextDirection direction)
+    {
+        textDirection = direction;
+    }
+
+    void on_modifiers_map(PlasmaWaylandProtocols::ArrayView<uint8_t> map)
+    {
+        modifiersMap.assign(map.begin(), map.end());
+    }
+
+    std::string commitString;
+    TextDirection textDirection = TextDirection::auto_;
+    std::vector<uint8_t> modifiersMap;
+};
+
+/* Builds a message in the wire format: object id, size and opcode, then the arguments. */
+class WireMessage
+{
+public:
+    WireMessage(uint32_t object, uint16_t opcode)
+        : m_words{object, opcode}
+    {
+    }
+
+    WireMessage &uint(uint32_t value)
+    {
+        m_words.push_back(value);
+        return *this;
+    }
+
+    WireMessage &string(const char *value)
+    {
+        return bytes(value, std::strlen(value) + 1);
+    }
+
+    WireMessage &bytes(const void *data, size_t size)
+    {
+        m_words.push_back(static_cast<uint32_t>(size));
+        const size_t offset = m_words.size();
+        m_words.resize(offset + (size + 3) / 4, 0);
+        std::memcpy(m_words.data() + offset, data, size);
+        return *this;
+    }
+
+    bool send(int fd)
+    {
+        const size_t size = m_words.size() * sizeof(uint32_t);
+        m_words[1] |= static_cast<uint32_t>(size << 16);
+        return write(fd, m_words.data(), size) == static_cast<ssize_t>(size);
+    }
+
+private:
+    std::vector<uint32_t> m_words;
+};
+
+bool check(bool condition, const char *what)
+{
+    if (!condition) {
+        std::fprintf(stderr, "cxx-bindings-dispatch: %s\n", what);
+    }
+    return condition;
+}
+
+}
+
+int main()
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+        std::perror("cxx-bindings-dispatch: socketpair");
+        return 1;
+    }
+    struct wl_display *display = wl_display_connect_to_fd(fds[0]);
+    if (!display) {
+        std::perror("cxx-bindings-dispatch: wl_display_connect_to_fd");
+        return 1;
+    }
+
+    // binding gives the proxy a version without a compositor announcing the global
+    struct wl_registry *registry = wl_display_get_registry(display);
+    TextInput textInput;
+    textInput.init(static_cast<TextInput::Object *>(wl_registry_bind(registry, 1, TextInput::interface(), 1)));
+    const uint32_t id = wl_proxy_get_id(reinterpret_cast<struct wl_proxy *>(textInput.object()));
+
+    static const char modifiers[] = "Shift\0Control";
+    const bool sent = WireMessage(id, uint16_t(TextInput::Event::commit_string)).string("Grüße").send(fds[1])
+        && WireMessage(id, uint16_t(TextInput::Event::text_direction)).uint(uint32_t(TextInput::TextDirection::rtl)).send(fds[1])
+        && WireMessage(id, uint16_t(TextInput::Event::modifiers_map)).bytes(modifiers, sizeof(modifiers)).send(fds[1]);
+    bool ok = check(sent, "failed to write the events");
+    while (ok && textInput.modifiersMap.empty()) {
+        ok = check(wl_display_dispatch(display) > 0, "failed to dispatch the events");
+    }
+    ok = ok && check(textInput.commitString == "Grüße", "commit_string did not reach on_commit_string");
+    ok = ok && check(textInput.textDirection == TextInput::TextDirection::rtl, "text_direction did not reach on_text_direction as TextDirection::rtl");
+    ok = ok && check(textInput.modifiersMap == std::vector<uint8_t>(modifiers, modifiers + sizeof(modifiers)), "modifiers_map did not reach on_modifiers_map");
+
+    // the last request on the wire has to carry the values of the enums
+    textInput.set_content_type(TextInput::ContentHint::latin | TextInput::ContentHint::multiline, TextInput::ContentPurpose::email);
+    const bool flushed = check(wl_display_flush(display) > 0, "failed to flush the requests");
+    uint32_t requests[64] = {};
+    const ssize_t received = flushed ? read(fds[1], requests, sizeof(requests)) : 0;
+    const size_t words = received > 0 ? static_cast<size_t>(received) / sizeof(uint32_t) : 0;
+    const uint32_t *last = nullptr;
+    for (size_t offset = 0; offset + 2 <= words && (requests[offset + 1] >> 16) >= 8;) {
+        last = requests + offset;
+        offset += (requests[offset + 1] >> 16) / sizeof(uint32_t);
+    }
+    const bool requestSent = check(last && last + 4 <= requests + words && last[0] == id && (last[1] & 0xffff) == uint32_t(TextInput::Request::set_content_type),
+                                   "set_content_type was not sent");
+    ok = requestSent
+        && check(last[2] == (ZWP_TEXT_INPUT_V2_CONTENT_HINT_LATIN | ZWP_TEXT_INPUT_V2_CONTENT_HINT_MULTILINE) && last[3] == ZWP_TEXT_INPUT_V2_CONTENT_PURPOSE_EMAIL,
+                 "set_content_type did not carry the enum values")
+        && ok;
+
+    textInput.destroy();
+    wl_registry_destroy(registry);
+    wl_display_disconnect(display);
+    close(fds[1]);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,921 @@
+// SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+// SPDX-License-Identifier: MIT
+
+/*
+ * Replays a trace written by tools/plasma-wayland-trace.py: the recorded
+ * requests are sent by a libwayland client and the recorded events by a headless
+ * libwayland-server that implements nothing but the globals seen in the trace,
+ * both in this process. The CPU and wall time the replay took is printed as JSON.
+ *
+ * Objects are mapped by their recorded ids, so the replayed ids may differ.
+ * Messages of interfaces that are neither core nor in this repository are skipped,
+ * as well as the events libwayland-server sends by itself, e.g. the registry
+ * globals and the callbacks of wl_display.sync.
+ */
+
+#define _GNU_SOURCE
+
+#include <wayland-client.h>
+#include <wayland-server.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TRACE_HEADER "# plasma-wayland-trace 1"
+#define MAX_ARGS 20
+#define SERVER_ID_START 0xff000000
+/* messages sent before the other side is given the chance to dispatch them */
+#define MAX_BACKLOG 64
+/* seconds without progress after which the replay is aborted */
+#define TIMEOUT 3
+
+/* in tracereplay-interfaces.c, generated from the protocols */
+extern const struct wl_interface *const tracereplay_protocol_interfaces[];
+
+static const struct wl_interface *const core_interfaces[] = {
+    &wl_display_interface,
+    &wl_registry_interface,
+    &wl_callback_interface,
+    &wl_compositor_interface,
+    &wl_shm_pool_interface,
+    &wl_shm_interface,
+    &wl_buffer_interface,
+    &wl_data_offer_interface,
+    &wl_data_source_interface,
+    &wl_data_device_interface,
+    &wl_data_device_manager_interface,
+    &wl_shell_interface,
+    &wl_shell_surface_interface,
+    &wl_surface_interface,
+    &wl_seat_interface,
+    &wl_pointer_interface,
+    &wl_keyboard_interface,
+    &wl_touch_interface,
+    &wl_output_interface,
+    &wl_region_interface,
+    &wl_subcompositor_interface,
+    &wl_subsurface_interface,
+    NULL,
+};
+
+struct entry {
+    double time;
+    /* R for requests, D for destructor requests, E for events, X for destructor events */
+    char kind;
+    char *interface;
+    uint32_t object;
+    char *message;
+    int arg_count;
+    char **args;
+};
+
+struct object {
+    const struct wl_interface *interface;
+    uint32_t version;
+    struct wl_proxy *proxy;
+    struct wl_resource *resource;
+    /* implemented by libwayland-server itself, e.g. the registry */
+    int internal;
+};
+
+struct object_table {
+    struct object *objects;
+    size_t size;
+};
+
+struct replay;
+
+struct global {
+    struct replay *replay;
+    uint32_t recorded_name;
+    /* the name announced in the replay */
+    uint32_t name;
+    const struct wl_interface *interface;
+    uint32_t version;
+};
+
+struct replay {
+    struct entry *entries;
+    size_t count;
+    struct global *globals;
+    size_t global_count;
+
+    struct object_table client_ids;
+    struct object_table server_ids;
+    /* entries sent by the client, in order, and how many the server received */
+    size_t *sent;
+    size_t sent_count;
+    size_t dispatched_count;
+    /* entries posted by the server, in order, and how many the client received */
+    size_t *posted;
+    size_t posted_count;
+    size_t received_count;
+    const struct entry *current_request;
+
+    struct wl_display *server;
+    struct wl_event_loop *loop;
+    struct wl_client *client;
+    struct wl_listener client_destroyed;
+    struct wl_display *display;
+
+    uint64_t requests;
+    uint64_t events;
+    uint64_t skipped;
+    int failed;
+};
+
+/* Storage of the arguments of one message */
+struct arguments {
+    union wl_argument args[MAX_ARGS];
+    char *strings[MAX_ARGS];
+    int string_count;
+    struct wl_array arrays[MAX_ARGS];
+    int array_count;
+    int fds[MAX_ARGS];
+    int fd_count;
+    /* the new_id argument, if any */
+    int new_id_arg;
+    const struct wl_interface *new_interface;
+    uint32_t new_id;
+};
+
+static double clock_ms(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static const struct wl_interface *find_interface(const char *name)
+{
+    for (int i = 0; core_interfaces[i]; i++) {
+        if (strcmp(core_interfaces[i]->name, name) == 0) {
+            return core_interfaces[i];
+        }
+    }
+    for (int i = 0; tracereplay_protocol_interfaces[i]; i++) {
+        if (strcmp(tracereplay_protocol_interfaces[i]->name, name) == 0) {
+            return tracereplay_protocol_interfaces[i];
+        }
+    }
+    return NULL;
+}
+
+static int find_message(const struct wl_message *messages, int count, const char *name)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(messages[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* The version a message was added in, which prefixes its signature. */
+static uint32_t message_since(const struct wl_message *message)
+{
+    return isdigit((unsigned char)message->signature[0]) ? (uint32_t)strtoul(message->signature, NULL, 10) : 1;
+}
+
+/* Returns the object with the recorded @p id, or NULL if it never existed. */
+static struct object *object_lookup(struct replay *replay, uint32_t id)
+{
+    struct object_table *table = id >= SERVER_ID_START ? &replay->server_ids : &replay->client_ids;
+    const size_t index = id >= SERVER_ID_START ? id - SERVER_ID_START : id;
+    return index < table->size ? &table->objects[index] : NULL;
+}
+
+/*
+ * Returns the object for the recorded @p id, cleared if it is created by the
+ * side calling this. Invalidates earlier lookups.
+ */
+static struct object *object_add(struct replay *replay, uint32_t id, int created)
+{
+    struct object_table *table = id >= SERVER_ID_START ? &replay->server_ids : &replay->client_ids;
+    const size_t index = id >= SERVER_ID_START ? id - SERVER_ID_START : id;
+    if (index >= table->size) {
+        size_t size = table->size ? table->size : 64;
+        while (size <= index) {
+            size *= 2;
+        }
+        table->objects = realloc(table->objects, size * sizeof(struct object));
+        memset(table->objects + table->size, 0, (size - table->size) * sizeof(struct object));
+        table->size = size;
+    }
+    if (created) {
+        memset(&table->objects[index], 0, sizeof(struct object));
+    }
+    return &table->objects[index];
+}
+
+static const char *token_value(const char *token)
+{
+    const char *value = strchr(token, ':');
+    return value ? value + 1 : "";
+}
+
+static char *decode_string(const char *token)
+{
+    if (token[0] == 'z') {
+        return NULL;
+    }
+    const char *value = token_value(token);
+    char *string = malloc(strlen(value) + 1);
+    char *out = string;
+    for (const char *in = value; *in; in++) {
+        if (in[0] == '%' && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2])) {
+            const char hex[3] = {in[1], in[2], '\0'};
+            *out++ = (char)strtoul(hex, NULL, 16);
+            in += 2;
+        } else {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+    return string;
+}
+
+/* Parses the "n:interface:id" token of a new object. */
+static uint32_t new_id_token(const char *token, const char **interface, size_t *interface_length)
+{
+    const char *id = strrchr(token, ':');
+    *interface = token_value(token);
+    *interface_length = id && id >= *interface ? (size_t)(id - *interface) : 0;
+    return id ? (uint32_t)strtoul(id + 1, NULL, 10) : 0;
+}
+
+static void free_arguments(struct arguments *arguments)
+{
+    for (int i = 0; i < arguments->string_count; i++) {
+        free(arguments->strings[i]);
+    }
+    for (int i = 0; i < arguments->array_count; i++) {
+        wl_array_release(&arguments->arrays[i]);
+    }
+    for (int i = 0; i < arguments->fd_count; i++) {
+        close(arguments->fds[i]);
+    }
+}
+
+/*
+ * Fills @p arguments from the recorded tokens, resolving objects on the client
+ * or the server side. The new_id argument is left to the caller.
+ */
+static int parse_arguments(struct replay *replay, const struct entry *entry, const struct wl_message *message, int server_side,
+                           struct arguments *arguments)
+{
+    memset(arguments, 0, sizeof(*arguments));
+    arguments->new_id_arg = -1;
+    int arg = 0;
+    for (const char *signature = message->signature; *signature; signature++) {
+        if (isdigit((unsigned char)*signature) || *signature == '?') {
+            continue;
+        }
+        if (arg >= entry->arg_count || arg >= MAX_ARGS) {
+            return -1;
+        }
+        const char *token = entry->args[arg];
+        const char *value = token_value(token);
+        union wl_argument *argument = &arguments->args[arg];
+        switch (*signature) {
+        case 'i':
+            argument->i = (int32_t)strtol(value, NULL, 10);
+            break;
+        case 'u':
+            argument->u = (uint32_t)strtoul(value, NULL, 10);
+            break;
+        case 'f':
+            argument->f = wl_fixed_from_double(strtod(value, NULL));
+            break;
+        case 's':
+            argument->s = arguments->strings[arguments->string_count++] = decode_string(token);
+            break;
+        case 'o': {
+            const uint32_t id = (uint32_t)strtoul(value, NULL, 10);
+            struct object *object = id ? object_lookup(replay, id) : NULL;
+            if (id && (!object || !(server_side ? (void *)object->resource : (void *)object->proxy))) {
+                return -1;
+            }
+            argument->o = object ? (server_side ? (struct wl_object *)object->resource : (struct wl_object *)object->proxy) : NULL;
+            break;
+        }
+        case 'n': {
+            const char *interface;
+            size_t length;
+            arguments->new_id = new_id_token(token, &interface, &length);
+            arguments->new_interface = message->types[arg];
+            if (!arguments->new_interface) {
+                // untyped, e.g. wl_registry.bind
+                char *name = strndup(interface, length);
+                arguments->new_interface = find_interface(name);
+                free(name);
+            }
+            if (!arguments->new_interface) {
+                return -1;
+            }
+            arguments->new_id_arg = arg;
+            argument->o = NULL;
+            break;
+        }
+        case 'a': {
+            struct wl_array *array = &arguments->arrays[arguments->array_count++];
+            const size_t size = strtoul(value, NULL, 10);
+            wl_array_init(array);
+            if (size && !wl_array_add(array, size)) {
+                return -1;
+            }
+            memset(array->data, 0, size);
+            argument->a = array;
+            break;
+        }
+        case 'h':
+            // the contents weren't recorded
+            argument->h = arguments->fds[arguments->fd_count++] = memfd_create("tracereplay", MFD_CLOEXEC);
+            break;
+        default:
+            return -1;
+        }
+        arg++;
+    }
+    return arg == entry->arg_count ? 0 : -1;
+}
+
+static struct global *find_global(struct replay *replay, uint32_t recorded_name)
+{
+    for (size_t i = 0; i < replay->global_count; i++) {
+        if (replay->globals[i].recorded_name == recorded_name) {
+            return &replay->globals[i];
+        }
+    }
+    return NULL;
+}
+
+/* Client side */
+
+static int client_dispatch(const void *implementation, void *target, uint32_t opcode, const struct wl_message *message, union wl_argument *args);
+
+static void add_client_dispatcher(struct replay *replay, struct wl_proxy *proxy, int internal)
+{
+    // internal objects are marked by not having user data
+    wl_proxy_add_dispatcher(proxy, client_dispatch, replay, internal ? NULL : replay);
+}
+
+static int client_dispatch(const void *implementation, void *target, uint32_t opcode, const struct wl_message *message, union wl_argument *args)
+{
+    (void)opcode;
+    struct replay *replay = (struct replay *)implementation;
+    const int internal = wl_proxy_get_user_data(target) == NULL;
+
+    if (internal) {
+        if (strcmp(wl_proxy_get_class(target), wl_registry_interface.name) == 0 && strcmp(message->name, "global") == 0) {
+            // the globals are created in the recorded order
+            for (size_t i = 0; i < replay->global_count; i++) {
+                struct global *global = &replay->globals[i];
+                if (!global->name && strcmp(global->interface->name, args[1].s) == 0) {
+                    global->name = args[0].u;
+                    break;
+                }
+            }
+        }
+        return 0;
+    }
+
+    if (replay->received_count >= replay->posted_count) {
+        fprintf(stderr, "tracereplay: unexpected event %s.%s\n", wl_proxy_get_class(target), message->name);
+        replay->failed = 1;
+        return 0;
+    }
+    const struct entry *entry = &replay->entries[replay->posted[replay->received_count++]];
+    if (strcmp(entry->message, message->name) != 0) {
+        fprintf(stderr, "tracereplay: received %s instead of %s\n", message->name, entry->message);
+        replay->failed = 1;
+        return 0;
+    }
+
+    int arg = 0;
+    for (const char *signature = message->signature; *signature; signature++) {
+        if (isdigit((unsigned char)*signature) || *signature == '?') {
+            continue;
+        }
+        if (*signature == 'n' && args[arg].o && arg < entry->arg_count) {
+            const char *interface;
+            size_t length;
+            struct object *object = object_add(replay, new_id_token(entry->args[arg], &interface, &length), 0);
+            object->proxy = (struct wl_proxy *)args[arg].o;
+            object->interface = message->types[arg];
+            object->version = wl_proxy_get_version(object->proxy);
+            add_client_dispatcher(replay, object->proxy, 0);
+        } else if (*signature == 'h') {
+            close(args[arg].h);
+        }
+        arg++;
+    }
+
+    if (entry->kind == 'X') {
+        // the server destroyed its resource after sending the event
+        struct object *object = object_lookup(replay, entry->object);
+        if (object && object->proxy == target) {
+            object->proxy = NULL;
+        }
+        wl_proxy_destroy(target);
+    }
+    return 0;
+}
+
+static void send_request(struct replay *replay, size_t index)
+{
+    const struct entry *entry = &replay->entries[index];
+    struct object *target = object_lookup(replay, entry->object);
+    const int opcode = target && target->proxy ? find_message(target->interface->methods, target->interface->method_count, entry->message) : -1;
+    const struct wl_message *message = opcode >= 0 ? &target->interface->methods[opcode] : NULL;
+    struct arguments arguments = {0};
+    if (!message || message_since(message) > target->version || parse_arguments(replay, entry, message, 0, &arguments) < 0) {
+        free_arguments(&arguments);
+        replay->skipped++;
+        return;
+    }
+
+    uint32_t version = target->version;
+    if (arguments.new_id_arg >= 0 && !message->types[arguments.new_id_arg]) {
+        // untyped new_id, preceded by the interface name and version
+        union wl_argument *args = arguments.args;
+        const int arg = arguments.new_id_arg;
+        const uint32_t supported = (uint32_t)arguments.new_interface->version;
+        version = args[arg - 1].u < supported ? args[arg - 1].u : supported;
+        args[arg - 1].u = version;
+        args[arg - 2].s = arguments.new_interface->name;
+        if (target->interface == &wl_registry_interface) {
+            struct global *global = find_global(replay, args[0].u);
+            if (!global || !global->name) {
+                free_arguments(&arguments);
+                replay->skipped++;
+                return;
+            }
+            args[0].u = global->name;
+        }
+    }
+
+    const int internal = target->interface == &wl_display_interface;
+    const int destroy = entry->kind == 'D';
+    struct wl_proxy *proxy = wl_proxy_marshal_array_flags(target->proxy, opcode, arguments.new_interface, version,
+                                                          destroy ? WL_MARSHAL_FLAG_DESTROY : 0, arguments.args);
+    if (destroy) {
+        target->proxy = NULL;
+    }
+    if (proxy) {
+        struct object *object = object_add(replay, arguments.new_id, 1);
+        object->proxy = proxy;
+        object->interface = arguments.new_interface;
+        object->version = version;
+        object->internal = internal;
+        add_client_dispatcher(replay, proxy, internal);
+    }
+    free_arguments(&arguments);
+    replay->sent[replay->sent_count++] = index;
+    replay->requests++;
+}
+
+/* Server side */
+
+static int server_dispatch(const void *implementation, void *target, uint32_t opcode, const struct wl_message *message, union wl_argument *args);
+
+static void protocol_logger(void *user_data, enum wl_protocol_logger_type type, const struct wl_protocol_logger_message *message)
+{
+    struct replay *replay = user_data;
+    if (type != WL_PROTOCOL_LOGGER_REQUEST) {
+        return;
+    }
+    // remember the recorded request for the dispatchers invoked next
+    if (replay->dispatched_count >= replay->sent_count) {
+        fprintf(stderr, "tracereplay: unexpected request %s\n", message->message->name);
+        replay->failed = 1;
+        replay->current_request = NULL;
+        return;
+    }
+    replay->current_request = &replay->entries[replay->sent[replay->dispatched_count++]];
+}
+
+static struct wl_resource *create_resource(struct replay *replay, const struct wl_interface *interface, uint32_t version, uint32_t id,
+                                           uint32_t recorded_id, int created)
+{
+    struct wl_resource *resource = wl_resource_create(replay->client, interface, version, id);
+    if (resource) {
+        wl_resource_set_dispatcher(resource, server_dispatch, replay, NULL, NULL);
+        struct object *object = object_add(replay, recorded_id, created);
+        object->resource = resource;
+        object->interface = interface;
+        object->version = version;
+    }
+    return resource;
+}
+
+static int server_dispatch(const void *implementation, void *target, uint32_t opcode, const struct wl_message *message, union wl_argument *args)
+{
+    (void)opcode;
+    struct replay *replay = (struct replay *)implementation;
+    const struct entry *entry = replay->current_request;
+    if (!entry) {
+        return 0;
+    }
+
+    int arg = 0;
+    for (const char *signature = message->signature; *signature; signature++) {
+        if (isdigit((unsigned char)*signature) || *signature == '?') {
+            continue;
+        }
+        if (*signature == 'n' && message->types[arg] && arg < entry->arg_count) {
+            const char *interface;
+            size_t length;
+            create_resource(replay, message->types[arg], wl_resource_get_version(target), args[arg].n,
+                            new_id_token(entry->args[arg], &interface, &length), 0);
+        } else if (*signature == 'h') {
+            close(args[arg].h);
+        }
+        arg++;
+    }
+
+    if (entry->kind == 'D') {
+        struct object *object = object_lookup(replay, entry->object);
+        if (object) {
+            object->resource = NULL;
+        }
+        wl_resource_destroy(target);
+    }
+    return 0;
+}
+
+static void global_bind(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+    (void)client;
+    struct global *global = data;
+    struct replay *replay = global->replay;
+    const struct entry *entry = replay->current_request;
+    if (entry && entry->arg_count > 0) {
+        const char *interface;
+        size_t length;
+        create_resource(replay, global->interface, version, id, new_id_token(entry->args[entry->arg_count - 1], &interface, &length), 0);
+    }
+}
+
+static void post_event(struct replay *replay, size_t index)
+{
+    const struct entry *entry = &replay->entries[index];
+    struct object *target = object_lookup(replay, entry->object);
+    if (target && target->internal) {
+        // sent by libwayland-server itself
+        return;
+    }
+    const int opcode = target && target->resource ? find_message(target->interface->events, target->interface->event_count, entry->message) : -1;
+    const struct wl_message *message = opcode >= 0 ? &target->interface->events[opcode] : NULL;
+    struct arguments arguments = {0};
+    if (!message || message_since(message) > (uint32_t)wl_resource_get_version(target->resource)
+        || parse_arguments(replay, entry, message, 1, &arguments) < 0) {
+        free_arguments(&arguments);
+        replay->skipped++;
+        return;
+    }
+
+    struct wl_resource *resource = target->resource;
+    if (arguments.new_id_arg >= 0) {
+        // created by the server, the client side is mapped when the event is received
+        struct wl_resource *created =
+            create_resource(replay, arguments.new_interface, wl_resource_get_version(resource), 0, arguments.new_id, 1);
+        if (!created) {
+            free_arguments(&arguments);
+            replay->skipped++;
+            return;
+        }
+        arguments.args[arguments.new_id_arg].o = (struct wl_object *)created;
+    }
+    wl_resource_post_event_array(resource, opcode, arguments.args);
+    free_arguments(&arguments);
+    if (entry->kind == 'X') {
+        // like a compositor, drop the resource after a destructor event such as wl_callback.done
+        target->resource = NULL;
+        wl_resource_destroy(resource);
+    }
+    replay->posted[replay->posted_count++] = index;
+    replay->events++;
+}
+
+/* Running */
+
+static void handle_client_destroyed(struct wl_listener *listener, void *data)
+{
+    (void)data;
+    struct replay *replay = wl_container_of(listener, replay, client_destroyed);
+    replay->client = NULL;
+}
+
+/* Lets the server dispatch all requests sent so far. */
+static int pump_server(struct replay *replay)
+{
+    int idle = 0;
+    while (replay->client && !replay->failed && replay->dispatched_count < replay->sent_count) {
+        const size_t dispatched = replay->dispatched_count;
+        if (wl_display_flush(replay->display) < 0 && errno != EAGAIN) {
+            return -1;
+        }
+        if (wl_event_loop_dispatch(replay->loop, 1000) < 0) {
+            return -1;
+        }
+        idle = replay->dispatched_count == dispatched ? idle + 1 : 0;
+        if (idle == TIMEOUT) {
+            return -1;
+        }
+    }
+    return replay->client && !replay->failed ? 0 : -1;
+}
+
+/* Lets the client dispatch all events posted so far, and wait for @p global to be announced. */
+static int pump_client(struct replay *replay, const struct global *global)
+{
+    int idle = 0;
+    while (replay->client && !replay->failed && (replay->received_count < replay->posted_count || (global && !global->name))) {
+        wl_display_flush_clients(replay->server);
+        if (wl_display_prepare_read(replay->display) != 0) {
+            if (wl_display_dispatch_pending(replay->display) < 0) {
+                return -1;
+            }
+            continue;
+        }
+        struct pollfd pollfd = {wl_display_get_fd(replay->display), POLLIN, 0};
+        if (poll(&pollfd, 1, 1000) <= 0) {
+            wl_display_cancel_read(replay->display);
+            if (++idle == TIMEOUT) {
+                return -1;
+            }
+            continue;
+        }
+        idle = 0;
+        if (wl_display_read_events(replay->display) < 0 || wl_display_dispatch_pending(replay->display) < 0) {
+            return -1;
+        }
+    }
+    return replay->client && !replay->failed ? 0 : -1;
+}
+
+static int run(struct replay *replay, double *cpu_ms, double *wall_ms)
+{
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) < 0) {
+        perror("tracereplay");
+        return -1;
+    }
+
+    replay->server = wl_display_create();
+    replay->loop = wl_display_get_event_loop(replay->server);
+    struct wl_protocol_logger *logger = wl_display_add_protocol_logger(replay->server, protocol_logger, replay);
+    for (size_t i = 0; i < replay->global_count; i++) {
+        struct global *global = &replay->globals[i];
+        global->name = 0;
+        wl_global_create(replay->server, global->interface, global->version, global, global_bind);
+    }
+    replay->client = wl_client_create(replay->server, sockets[0]);
+    replay->display = wl_display_connect_to_fd(sockets[1]);
+    if (!replay->client || !replay->display) {
+        fprintf(stderr, "tracereplay: failed to connect\n");
+        return -1;
+    }
+    replay->client_destroyed.notify = handle_client_destroyed;
+    wl_client_add_destroy_listener(replay->client, &replay->client_destroyed);
+
+    // wl_display is the only object that exists from the start
+    struct object *display = object_add(replay, 1, 1);
+    display->proxy = (struct wl_proxy *)replay->display;
+    display->interface = &wl_display_interface;
+    display->version = 1;
+    display->internal = 1;
+
+    const double cpu_start = clock_ms(CLOCK_PROCESS_CPUTIME_ID);
+    const double wall_start = clock_ms(CLOCK_MONOTONIC);
+    int result = 0;
+    for (size_t i = 0; i < replay->count && result == 0; i++) {
+        const struct entry *entry = &replay->entries[i];
+        if (entry->kind == 'E' || entry->kind == 'X') {
+            result = pump_server(replay);
+            if (result == 0) {
+                post_event(replay, i);
+                if (replay->posted_count - replay->received_count >= MAX_BACKLOG) {
+                    result = pump_client(replay, NULL);
+                }
+            }
+        } else {
+            const struct global *global = NULL;
+            if (strcmp(entry->interface, wl_registry_interface.name) == 0 && strcmp(entry->message, "bind") == 0 && entry->arg_count > 0) {
+                global = find_global(replay, (uint32_t)strtoul(token_value(entry->args[0]), NULL, 10));
+                if (global && !global->name) {
+                    // the globals are announced once the registry was created
+                    result = pump_server(replay);
+                }
+            }
+            if (result == 0) {
+                result = pump_client(replay, global);
+            }
+            if (result == 0) {
+                send_request(replay, i);
+                if (replay->sent_count - replay->dispatched_count >= MAX_BACKLOG) {
+                    result = pump_server(replay);
+                }
+            }
+        }
+    }
+    if (result == 0) {
+        result = pump_server(replay);
+    }
+    if (result == 0) {
+        result = pump_client(replay, NULL);
+    }
+    *cpu_ms = clock_ms(CLOCK_PROCESS_CPUTIME_ID) - cpu_start;
+    *wall_ms = clock_ms(CLOCK_MONOTONIC) - wall_start;
+
+    if (result < 0) {
+        fprintf(stderr, "tracereplay: replay stopped after %zu requests and %zu events\n", replay->dispatched_count, replay->received_count);
+    }
+    wl_display_disconnect(replay->display);
+    if (replay->client) {
+        wl_list_remove(&replay->client_destroyed.link);
+    }
+    wl_protocol_logger_destroy(logger);
+    wl_display_destroy_clients(replay->server);
+    wl_display_destroy(replay->server);
+
+    free(replay->client_ids.objects);
+    free(replay->server_ids.objects);
+    memset(&replay->client_ids, 0, sizeof(replay->client_ids));
+    memset(&replay->server_ids, 0, sizeof(replay->server_ids));
+    replay->sent_count = replay->dispatched_count = replay->posted_count = replay->received_count = 0;
+    replay->current_request = NULL;
+    return result;
+}
+
+/* Loading */
+
+static int load(struct replay *replay, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+
+    char *line = NULL;
+    size_t capacity = 0;
+    size_t allocated = 0;
+    int valid = 0;
+    while (getline(&line, &capacity, file) >= 0) {
+        line[strcspn(line, "\n")] = '\0';
+        if (strcmp(line, TRACE_HEADER) == 0) {
+            valid = 1;
+        }
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+
+        char *tokens[5 + MAX_ARGS];
+        int token_count = 0;
+        for (char *token = strtok(line, " "); token && token_count < 5 + MAX_ARGS; token = strtok(NULL, " ")) {
+            tokens[token_count++] = token;
+        }
+        if (token_count < 5 || !strchr("RDEX", tokens[1][0])) {
+            fprintf(stderr, "%s: invalid line\n", path);
+            continue;
+        }
+
+        if (replay->count == allocated) {
+            allocated = allocated ? allocated * 2 : 1024;
+            replay->entries = realloc(replay->entries, allocated * sizeof(struct entry));
+        }
+        struct entry *entry = &replay->entries[replay->count++];
+        entry->time = strtod(tokens[0], NULL);
+        entry->kind = tokens[1][0];
+        entry->interface = strdup(tokens[2]);
+        entry->object = (uint32_t)strtoul(tokens[3], NULL, 10);
+        entry->message = strdup(tokens[4]);
+        entry->arg_count = token_count - 5;
+        entry->args = calloc(entry->arg_count + 1, sizeof(char *));
+        for (int i = 0; i < entry->arg_count; i++) {
+            entry->args[i] = strdup(tokens[5 + i]);
+        }
+    }
+    free(line);
+    fclose(file);
+    if (!valid) {
+        fprintf(stderr, "%s: not a trace, convert it with plasma-wayland-trace.py first\n", path);
+        return -1;
+    }
+
+    // create the recorded globals that can be implemented
+    replay->globals = calloc(replay->count + 1, sizeof(struct global));
+    for (size_t i = 0; i < replay->count; i++) {
+        const struct entry *entry = &replay->entries[i];
+        if (entry->kind != 'E' || strcmp(entry->interface, wl_registry_interface.name) != 0 || strcmp(entry->message, "global") != 0
+            || entry->arg_count != 3) {
+            continue;
+        }
+        const uint32_t recorded_name = (uint32_t)strtoul(token_value(entry->args[0]), NULL, 10);
+        char *name = decode_string(entry->args[1]);
+        const struct wl_interface *interface = name ? find_interface(name) : NULL;
+        free(name);
+        if (!interface || interface == &wl_display_interface || interface == &wl_registry_interface || find_global(replay, recorded_name)) {
+            continue;
+        }
+        const uint32_t version = (uint32_t)strtoul(token_value(entry->args[2]), NULL, 10);
+        struct global *global = &replay->globals[replay->global_count++];
+        global->replay = replay;
+        global->recorded_name = recorded_name;
+        global->interface = interface;
+        global->version = version < (uint32_t)interface->version ? version : (uint32_t)interface->version;
+    }
+
+    replay->sent = calloc(replay->count + 1, sizeof(size_t));
+    replay->posted = calloc(replay->count + 1, sizeof(size_t));
+    return 0;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv)
+{
+    int repeat = 5;
+    FILE *output = stdout;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = fopen(argv[++i], "w");
+            if (!output) {
+                perror("tracereplay");
+                return 1;
+            }
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path || repeat < 1) {
+        fprintf(stderr, "Usage: %s [--repeat N] [--output FILE] TRACE\n", argv[0]);
+        return 1;
+    }
+
+    struct replay replay;
+    memset(&replay, 0, sizeof(replay));
+    if (load(&replay, path) < 0) {
+        return 1;
+    }
+
+    double *cpu_ms = calloc(repeat, sizeof(double));
+    double *wall_ms = calloc(repeat, sizeof(double));
+    int failed = 0;
+    for (int i = 0; i < repeat && !failed; i++) {
+        // every run replays the same messages, only count them once
+        replay.requests = replay.events = replay.skipped = 0;
+        failed = run(&replay, &cpu_ms[i], &wall_ms[i]) < 0;
+    }
+
+    if (!failed) {
+        qsort(cpu_ms, repeat, sizeof(double), compare_doubles);
+        qsort(wall_ms, repeat, sizeof(double), compare_doubles);
+        fprintf(output,
+                "{\n  \"trace\": \"%s\", \"runs\": %d, \"messages\": %llu, \"requests\": %llu, \"events\": %llu, \"skipped\": %llu,\n"
+                "  \"cpu_ms\": %.3f, \"wall_ms\": %.3f, \"min_cpu_ms\": %.3f, \"min_wall_ms\": %.3f\n}\n",
+                path, repeat, (unsigned long long)(replay.requests + replay.events), (unsigned long long)replay.requests,
+                (unsigned long long)replay.events, (unsigned long long)replay.skipped, cpu_ms[repeat / 2], wall_ms[repeat / 2], cpu_ms[0],
+                wall_ms[0]);
+    }
+    if (output != stdout) {
+        fclose(output);
+    }
+
+    for (size_t i = 0; i < replay.count; i++) {
+        for (int j = 0; j < replay.entries[i].arg_count; j++) {
+            free(replay.entries[i].args[j]);
+        }
+        free(replay.entries[i].args);
+        free(replay.entries[i].interface);
+        free(replay.entries[i].message);
+    }
+    free(replay.entries);
+    free(replay.globals);
+    free(replay.sent);
+    free(replay.posted);
+    free(cpu_ms);
+    free(wall_ms);
+    return failed;
+}
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+// SPDX-License-Identifier: MIT
+
+/*
+ * Client side of the wirecost scenarios. Events are received through a generic
+ * dispatcher so that every event is demarshalled like in a real client without
+ * having to spell out a listener for every interface.
+ */
+
+#include "wirecost.h"
+
+#include "kde-output-device-v2-client-protocol.h"
+#include "org-kde-plasma-virtual-desktop-client-protocol.h"
+#include "plasma-window-management-client-protocol.h"
+
+#include <wayland-client.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Called for every event of a proxy in addition to the generic handling. */
+typedef void (*event_hook)(void *data, const struct wl_message *message, union wl_argument *args);
+
+struct global {
+    uint32_t name;
+    uint32_t version;
+};
+
+struct string_list {
+    char **strings;
+    size_t count;
+};
+
+static int dispatch(const void *implementation, void *target, uint32_t opcode, const struct wl_message *message, union wl_argument *args);
+
+static void add_dispatcher(void *proxy, event_hook hook, void *data)
+{
+    wl_proxy_add_dispatcher(proxy, dispatch, (const void *)hook, data);
+}
+
+static int dispatch(const void *implementation, void *target, uint32_t opcode, const struct wl_message *message, union wl_argument *args)
+{
+    (void)opcode;
+    int i = 0;
+    for (const char *signature = message->signature; *signature; signature++) {
+        switch (*signature) {
+        case 'n':
+            // objects created by the server, e.g. output modes
+            if (args[i].o) {
+                add_dispatcher(args[i].o, NULL, NULL);
+            }
+            i++;
+            break;
+        case 'h':
+            close(args[i].h);
+            i++;
+            break;
+        case 'i':
+        case 'u':
+        case 'f':
+        case 's':
+        case 'o':
+        case 'a':
+            i++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    event_hook hook = (event_hook)implementation;
+    if (hook) {
+        hook(wl_proxy_get_user_data(target), message, args);
+    }
+    return 0;
+}
+
+static void roundtrip(struct wl_display *display, struct wirecost_stats *stats)
+{
+    wl_display_roundtrip(display);
+    stats->roundtrips++;
+}
+
+static void append_string(struct string_list *list, const char *string)
+{
+    list->strings = realloc(list->strings, (list->count + 1) * sizeof(char *));
+    list->strings[list->count++] = strdup(string);
+}
+
+static void free_strings(struct string_list *list)
+{
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->strings[i]);
+    }
+    free(list->strings);
+}
+
+struct registry_lookup {
+    const char *interface;
+    struct global global;
+};
+
+static void registry_event(void *data, const struct wl_message *message, union wl_argument *args)
+{
+    struct registry_lookup *lookup = data;
+    if (strcmp(message->name, "global") == 0 && strcmp(args[1].s, lookup->interface) == 0) {
+        lookup->global.name = args[0].u;
+        lookup->global.version = args[2].u;
+    }
+}
+
+/* Binds the global implementing @p interface with at most @p version. */
+static void *bind_global(struct wl_display *display, const struct wl_interface *interface, uint32_t version, struct wirecost_stats *stats,
+                         event_hook hook, void *data)
+{
+    struct registry_lookup lookup = {interface->name, {0, 0}};
+    struct wl_registry *registry = wl_display_get_registry(display);
+    add_dispatcher(registry, registry_event, &lookup);
+    roundtrip(display, stats);
+    if (!lookup.global.name) {
+        fprintf(stderr, "wirecost: %s is not announced\n", interface->name);
+        wl_registry_destroy(registry);
+        return NULL;
+    }
+
+    void *proxy = wl_registry_bind(registry, lookup.global.name, interface, version < lookup.global.version ? version : lookup.global.version);
+    add_dispatcher(proxy, hook, data);
+    wl_registry_destroy(registry);
+    return proxy;
+}
+
+/* Window management */
+
+static void window_management_event(void *data, const struct wl_message *message, union wl_argument *args)
+{
+    if (strcmp(message->name, "window_with_uuid") == 0) {
+        append_string(data, args[1].s);
+    }
+}
+
+void wirecost_client_window_management(struct wl_display *display, const struct wirecost_scenario *scenario, struct wirecost_stats *stats)
+{
+    // desktop ids are resolved through virtual desktop management, which has to be bound first to receive compact ids
+    const uint32_t desktops_version = scenario->version >= ORG_KDE_PLASMA_WINDOW_VIRTUAL_DESKTOPS_SINCE_VERSION
+        ? ORG_KDE_PLASMA_VIRTUAL_DESKTOP_MANAGEMENT_DESKTOP_INFO_SINCE_VERSION
+        : ORG_KDE_PLASMA_VIRTUAL_DESKTOP_MANAGEMENT_DESKTOP_INFO_SINCE_VERSION - 1;
+    if (!bind_global(display, &org_kde_plasma_virtual_desktop_management_interface, desktops_version, stats, NULL, NULL)) {
+        return;
+    }
+
+    struct string_list uuids = {NULL, 0};
+    struct org_kde_plasma_window_management *management =
+        bind_global(display, &org_kde_plasma_window_management_interface, scenario->version, stats, window_management_event, &uuids);
+    if (!management) {
+        return;
+    }
+    roundtrip(display, stats);
+
+    for (size_t i = 0; i < uuids.count; i++) {
+        struct org_kde_plasma_window *window = org_kde_plasma_window_management_get_window_by_uuid(management, uuids.strings[i]);
+        add_dispatcher(window, NULL, NULL);
+    }
+    roundtrip(display, stats);
+    free_strings(&uuids);
+}
+
+/* Output devices */
+
+void wirecost_client_output_devices(struct wl_display *display, const struct wirecost_scenario *scenario, struct wirecost_stats *stats)
+{
+    // the devices and their modes are announced right after binding
+    if (bind_global(display, &kde_output_device_registry_v2_interface, scenario->version, stats, NULL, NULL)) {
+        roundtrip(display, stats);
+    }
+}
+
+/* Virtual desktops */
+
+static void virtual_desktop_management_event(void *data, const struct wl_message *message, union wl_argument *args)
+{
+    if (strcmp(message->name, "desktop_created") == 0) {
+        append_string(data, args[0].s);
+    }
+}
+
+void wirecost_client_virtual_desktops(struct wl_display *display, const struct wirecost_scenario *scenario, struct wirecost_stats *stats)
+{
+    struct string_list ids = {NULL, 0};
+    struct org_kde_plasma_virtual_desktop_management *management = bind_global(display, &org_kde_plasma_virtual_desktop_management_interface,
+                                                                                scenario->version, stats, virtual_desktop_management_event, &ids);
+    if (!management) {
+        return;
+    }
+    roundtrip(display, stats);
+
+    // older versions need an object per desktop to learn its name and state
+    if (wl_proxy_get_version((struct wl_proxy *)management) < ORG_KDE_PLASMA_VIRTUAL_DESKTOP_MANAGEMENT_DESKTOP_INFO_SINCE_VERSION) {
+        for (size_t i = 0; i < ids.count; i++) {
+            struct org_kde_plasma_virtual_desktop *desktop = org_kde_plasma_virtual_desktop_management_get_virtual_desktop(management, ids.strings[i]);
+            add_dispatcher(desktop, NULL, NULL);
+        }
+        roundtrip(display, stats);
+    }
+    free_strings(&ids);
+}
@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+// SPDX-License-Identifier: MIT
+
+/*
+ * Server side of the wirecost scenarios. Every global sends the state a real
+ * compositor would send, with plausible string lengths, so that the measured
+ * sizes are representative.
+ */
+
+#define _GNU_SOURCE
+
+#include "wirecost.h"
+
+#include "kde-output-device-v2-server-protocol.h"
+#include "org-kde-plasma-virtual-desktop-server-protocol.h"
+#include "plasma-window-management-server-protocol.h"
+
+#include <wayland-server.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define WINDOW_UUID_FORMAT "{%08x-5d2c-4d6a-9b1f-3a7c0e2b8f41}"
+#define DESKTOP_ID_FORMAT "%08x-1f0e-4b3a-8c2d-6e5f4a3b2c1d"
+
+static int supports(struct wl_resource *resource, uint32_t since)
+{
+    return wl_resource_get_version(resource) >= (int)since;
+}
+
+static void send_virtual_desktop_management(struct wl_client *client, void *data, uint32_t version, uint32_t id, unsigned int count);
+
+/* Window management */
+
+static enum wl_iterator_result find_compact_desktop_ids(struct wl_resource *resource, void *data)
+{
+    int *found = data;
+    if (wl_resource_instance_of(resource, &org_kde_plasma_virtual_desktop_management_interface, NULL)
+        && supports(resource, ORG_KDE_PLASMA_VIRTUAL_DESKTOP_MANAGEMENT_DESKTOP_INFO_SINCE_VERSION)) {
+        *found = 1;
+        return WL_ITERATOR_STOP;
+    }
+    return WL_ITERATOR_CONTINUE;
+}
+
+/* Whether @p client can resolve compact desktop ids, i.e. bound virtual desktop management version 5. */
+static int has_compact_desktop_ids(struct wl_client *client)
+{
+    int found = 0;
+    wl_client_for_each_resource(client, find_compact_desktop_ids, &found);
+    return found;
+}
+
+static void window_management_get_window_by_uuid(struct wl_client *client, struct wl_resource *resource, uint32_t id, const char *internal_window_uuid)
+{
+    const struct wirecost_scenario *scenario = wl_resource_get_user_data(resource);
+    unsigned int index = 0;
+    sscanf(internal_window_uuid, WINDOW_UUID_FORMAT, &index);
+
+    struct wl_resource *window = wl_resource_create(client, &org_kde_plasma_window_interface, wl_resource_get_version(resource), id);
+    wl_resource_set_implementation(window, NULL, NULL, NULL);
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "Document %u.txt - Kate", index);
+    org_kde_plasma_window_send_title_changed(window, buffer);
+    org_kde_plasma_window_send_app_id_changed(window, "org.kde.kate");
+    org_kde_plasma_window_send_state_changed(window, ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STATE_MINIMIZABLE | ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STATE_MAXIMIZABLE
+                                                         | ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STATE_CLOSEABLE);
+    org_kde_plasma_window_send_themed_icon_name_changed(window, "kate");
+    org_kde_plasma_window_send_pid_changed(window, 1000 + index);
+    org_kde_plasma_window_send_geometry(window, 100, 100, 1280, 800);
+    if (supports(window, ORG_KDE_PLASMA_WINDOW_RESOURCE_NAME_CHANGED_SINCE_VERSION)) {
+        org_kde_plasma_window_send_resource_name_changed(window, "kate");
+    }
+    if (supports(window, ORG_KDE_PLASMA_WINDOW_CLIENT_GEOMETRY_SINCE_VERSION)) {
+        org_kde_plasma_window_send_client_geometry(window, 100, 130, 1280, 770);
+    }
+
+    // every window is on scenario->detail desktops
+    if (supports(window, ORG_KDE_PLASMA_WINDOW_VIRTUAL_DESKTOPS_SINCE_VERSION) && has_compact_desktop_ids(client)) {
+        struct wl_array desktops;
+        wl_array_init(&desktops);
+        for (unsigned int i = 0; i < scenario->detail; i++) {
+            uint32_t *desktop = wl_array_add(&desktops, sizeof(uint32_t));
+            *desktop = i;
+        }
+        org_kde_plasma_window_send_virtual_desktops(window, &desktops);
+        wl_array_release(&desktops);
+    } else {
+        for (unsigned int i = 0; i < scenario->detail; i++) {
+            snprintf(buffer, sizeof(buffer), DESKTOP_ID_FORMAT, i);
+            org_kde_plasma_window_send_virtual_desktop_entered(window, buffer);
+        }
+    }
+    org_kde_plasma_window_send_activity_entered(window, "f0a5a6c8-6b8e-4a4b-9c6b-2c3c9d6e7f80");
+    org_kde_plasma_window_send_initial_state(window);
+}
+
+static const struct org_kde_plasma_window_management_interface window_management_implementation = {
+    .get_window_by_uuid = window_management_get_window_by_uuid,
+};
+
+static void window_management_bind(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+    const struct wirecost_scenario *scenario = data;
+    struct wl_resource *resource = wl_resource_create(client, &org_kde_plasma_window_management_interface, version, id);
+    wl_resource_set_implementation(resource, &window_management_implementation, data, NULL);
+
+    char uuid[64];
+    for (unsigned int i = 0; i < scenario->count; i++) {
+        snprintf(uuid, sizeof(uuid), WINDOW_UUID_FORMAT, i);
+        org_kde_plasma_window_management_send_window_with_uuid(resource, i, uuid);
+    }
+    org_kde_plasma_window_management_send_stacking_order_changed_2(resource);
+}
+
+/* The desktops the windows are on, so that the client can resolve their ids. */
+static void window_management_virtual_desktops_bind(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+    const struct wirecost_scenario *scenario = data;
+    send_virtual_desktop_management(client, data, version, id, scenario->detail);
+}
+
+void wirecost_server_window_management(struct wl_display *display, const struct wirecost_scenario *scenario)
+{
+    wl_global_create(display, &org_kde_plasma_virtual_desktop_management_interface, org_kde_plasma_virtual_desktop_management_interface.version,
+                     (void *)scenario, window_management_virtual_desktops_bind);
+    wl_global_create(display, &org_kde_plasma_window_management_interface, org_kde_plasma_window_management_interface.version, (void *)scenario,
+                     window_management_bind);
+}
+
+/* Output devices */
+
+/* Sends @p size bytes of profile data in a sealed memfd, an empty one if no profile is set. */
+static void send_icc_profile_content(struct wl_resource *device, uint32_t usage, uint32_t size, const char *hash)
+{
+    int fd = memfd_create("icc-profile", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        return;
+    }
+    if (ftruncate(fd, size) == 0) {
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+        kde_output_device_v2_send_icc_profile_content(device, usage, fd, size, hash);
+    }
+    close(fd);
+}
+
+static void send_output_device(struct wl_client *client, struct wl_resource *registry, const struct wirecost_scenario *scenario, unsigned int index)
+{
+    struct wl_resource *device = wl_resource_create(client, &kde_output_device_v2_interface, wl_resource_get_version(registry), 0);
+    wl_resource_set_implementation(device, NULL, NULL, NULL);
+    kde_output_device_registry_v2_send_output(registry, device);
+
+    char buffer[512];
+    kde_output_device_v2_send_geometry(device, 2560 * index, 0, 600, 340, KDE_OUTPUT_DEVICE_V2_SUBPIXEL_UNKNOWN, "Dell Inc.", "DELL U2723QE",
+                                       KDE_OUTPUT_DEVICE_V2_TRANSFORM_NORMAL);
+
+    struct wl_resource *current = NULL;
+    for (unsigned int i = 0; i < scenario->detail; i++) {
+        struct wl_resource *mode = wl_resource_create(client, &kde_output_device_mode_v2_interface, wl_resource_get_version(device), 0);
+        wl_resource_set_implementation(mode, NULL, NULL, NULL);
+        kde_output_device_v2_send_mode(device, mode);
+        kde_output_device_mode_v2_send_size(mode, 3840 - (i % 30) * 64, 2160 - (i % 30) * 36);
+        kde_output_device_mode_v2_send_refresh(mode, 60000 - (i / 30) * 1000);
+        if (supports(mode, KDE_OUTPUT_DEVICE_MODE_V2_FLAGS_SINCE_VERSION)) {
+            kde_output_device_mode_v2_send_flags(mode, 0);
+        }
+        if (i == 0) {
+            kde_output_device_mode_v2_send_preferred(mode);
+            current = mode;
+        }
+    }
+    if (current) {
+        kde_output_device_v2_send_current_mode(device, current);
+    }
+
+    kde_output_device_v2_send_scale(device, wl_fixed_from_double(1.5));
+    // a 256 byte EDID, base64 encoded
+    memset(buffer, 'A', 344);
+    buffer[344] = '\0';
+    kde_output_device_v2_send_edid(device, buffer);
+    kde_output_device_v2_send_enabled(device, 1);
+    snprintf(buffer, sizeof(buffer), "5e7d0e1c-9a4b-4c2d-8e3f-%012x", index);
+    kde_output_device_v2_send_uuid(device, buffer);
+    kde_output_device_v2_send_serial_number(device, "CN0ABCDE123456");
+    kde_output_device_v2_send_eisa_id(device, "DEL");
+    kde_output_device_v2_send_capabilities(device, KDE_OUTPUT_DEVICE_V2_CAPABILITY_OVERSCAN | KDE_OUTPUT_DEVICE_V2_CAPABILITY_VRR
+                                                       | KDE_OUTPUT_DEVICE_V2_CAPABILITY_RGB_RANGE | KDE_OUTPUT_DEVICE_V2_CAPABILITY_ICC_PROFILE);
+    kde_output_device_v2_send_overscan(device, 0);
+    kde_output_device_v2_send_vrr_policy(device, KDE_OUTPUT_DEVICE_V2_VRR_POLICY_AUTOMATIC);
+    kde_output_device_v2_send_rgb_range(device, KDE_OUTPUT_DEVICE_V2_RGB_RANGE_AUTOMATIC);
+    snprintf(buffer, sizeof(buffer), "DP-%u", index + 1);
+    kde_output_device_v2_send_name(device, buffer);
+    kde_output_device_v2_send_high_dynamic_range(device, 0);
+    kde_output_device_v2_send_sdr_brightness(device, 200);
+    kde_output_device_v2_send_wide_color_gamut(device, 0);
+    kde_output_device_v2_send_auto_rotate_policy(device, KDE_OUTPUT_DEVICE_V2_AUTO_ROTATE_POLICY_IN_TABLET_MODE);
+    kde_output_device_v2_send_icc_profile_path(device, "/home/user/.local/share/icc/DELL_U2723QE.icc");
+    kde_output_device_v2_send_brightness_metadata(device, 400, 350, 1);
+    kde_output_device_v2_send_brightness_overrides(device, -1, -1, -1);
+    kde_output_device_v2_send_sdr_gamut_wideness(device, 0);
+    kde_output_device_v2_send_color_profile_source(device, KDE_OUTPUT_DEVICE_V2_COLOR_PROFILE_SOURCE_ICC);
+    kde_output_device_v2_send_brightness(device, 10000);
+    kde_output_device_v2_send_color_power_tradeoff(device, KDE_OUTPUT_DEVICE_V2_COLOR_POWER_TRADEOFF_EFFICIENCY);
+    kde_output_device_v2_send_dimming(device, 10000);
+    kde_output_device_v2_send_replication_source(device, "");
+    kde_output_device_v2_send_ddc_ci_allowed(device, 1);
+    kde_output_device_v2_send_max_bits_per_color(device, 0);
+    kde_output_device_v2_send_max_bits_per_color_range(device, 6, 10);
+    kde_output_device_v2_send_automatic_max_bits_per_color_limit(device, 8);
+    kde_output_device_v2_send_edr_policy(device, KDE_OUTPUT_DEVICE_V2_EDR_POLICY_ALWAYS);
+    kde_output_device_v2_send_sharpness(device, 0);
+    kde_output_device_v2_send_priority(device, index + 1);
+    kde_output_device_v2_send_auto_brightness(device, 0);
+    kde_output_device_v2_send_hdr_icc_profile_path(device, "");
+    kde_output_device_v2_send_hdr_color_profile_source(device, KDE_OUTPUT_DEVICE_V2_COLOR_PROFILE_SOURCE_SRGB);
+    kde_output_device_v2_send_abm_level(device, 0);
+
+    if (supports(device, KDE_OUTPUT_DEVICE_V2_ICC_PROFILE_CONTENT_SINCE_VERSION)) {
+        // a typical display profile is a few kilobytes, no HDR profile is set
+        send_icc_profile_content(device, KDE_OUTPUT_DEVICE_V2_ICC_PROFILE_USAGE_SDR, 3144, "3f9b2c1d0e8a7b6c5d4e3f2a1b0c9d8e7f6a5b4c3d2e1f0a9b8c7d6e5f4a3b2c");
+        send_icc_profile_content(device, KDE_OUTPUT_DEVICE_V2_ICC_PROFILE_USAGE_HDR, 0, "");
+    }
+    kde_output_device_v2_send_done(device);
+}
+
+static void output_device_registry_bind(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+    const struct wirecost_scenario *scenario = data;
+    struct wl_resource *registry = wl_resource_create(client, &kde_output_device_registry_v2_interface, version, id);
+    wl_resource_set_implementation(registry, NULL, NULL, NULL);
+
+    for (unsigned int i = 0; i < scenario->count; i++) {
+        send_output_device(client, registry, scenario, i);
+    }
+    if (supports(registry, KDE_OUTPUT_DEVICE_REGISTRY_V2_SETTLED_SINCE_VERSION)) {
+        kde_output_device_registry_v2_send_settled(registry);
+    }
+}
+
+void wirecost_server_output_devices(struct wl_display *display, const struct wirecost_scenario *scenario)
+{
+    wl_global_create(display, &kde_output_device_registry_v2_interface, kde_output_device_registry_v2_interface.version, (void *)scenario,
+                     output_device_registry_bind);
+}
+
+/* Virtual desktops */
+
+static void virtual_desktop_management_get_virtual_desktop(struct wl_client *client, struct wl_resource *resource, uint32_t id, const char *desktop_id)
+{
+    unsigned int index = 0;
+    sscanf(desktop_id, DESKTOP_ID_FORMAT, &index);
+
+    struct wl_resource *desktop = wl_resource_create(client, &org_kde_plasma_virtual_desktop_interface, wl_resource_get_version(resource), id);
+    wl_resource_set_implementation(desktop, NULL, NULL, NULL);
+
+    char name[64];
+    snprintf(name, sizeof(name), "Desktop %u", index + 1);
+    org_kde_plasma_virtual_desktop_send_desktop_id(desktop, desktop_id);
+    org_kde_plasma_virtual_desktop_send_name(desktop, name);
+    org_kde_plasma_virtual_desktop_send_position(desktop, index);
+    if (index == 0) {
+        org_kde_plasma_virtual_desktop_send_activated(desktop);
+        org_kde_plasma_virtual_desktop_send_output_entered(desktop, "DP-1");
+        org_kde_plasma_virtual_desktop_send_output_entered(desktop, "DP-2");
+    }
+    if (supports(desktop, ORG_KDE_PLASMA_VIRTUAL_DESKTOP_COMPACT_ID_SINCE_VERSION)) {
+        org_kde_plasma_virtual_desktop_send_compact_id(desktop, index);
+    }
+    org_kde_plasma_virtual_desktop_send_done(desktop);
+}
+
+static const struct org_kde_plasma_virtual_desktop_management_interface virtual_desktop_management_implementation = {
+    .get_virtual_desktop = virtual_desktop_management_get_virtual_desktop,
+};
+
+/* Binds virtual desktop management and announces @p count desktops. */
+static void send_virtual_desktop_management(struct wl_client *client, void *data, uint32_t version, uint32_t id, unsigned int count)
+{
+    struct wl_resource *resource = wl_resource_create(client, &org_kde_plasma_virtual_desktop_management_interface, version, id);
+    wl_resource_set_implementation(resource, &virtual_desktop_management_implementation, data, NULL);
+
+    char desktop_id[64];
+    char name[64];
+    for (unsigned int i = 0; i < count; i++) {
+        snprintf(desktop_id, sizeof(desktop_id), DESKTOP_ID_FORMAT, i);
+        org_kde_plasma_virtual_desktop_management_send_desktop_created(resource, desktop_id, i);
+        if (supports(resource, ORG_KDE_PLASMA_VIRTUAL_DESKTOP_MANAGEMENT_DESKTOP_INFO_SINCE_VERSION)) {
+            struct wl_array outputs;
+            wl_array_init(&outputs);
+            if (i == 0) {
+                static const char active[] = "DP-1\0DP-2";
+                memcpy(wl_array_add(&outputs, sizeof(active)), active, sizeof(active));
+            }
+            snprintf(name, sizeof(name), "Desktop %u", i + 1);
+            org_kde_plasma_virtual_desktop_management_send_desktop_info(resource, i, desktop_id, name, i, &outputs);
+            wl_array_release(&outputs);
+        }
+    }
+    org_kde_plasma_virtual_desktop_management_send_rows(resource, 4);
+    org_kde_plasma_virtual_desktop_management_send_done(resource);
+}
+
+static void virtual_desktop_management_bind(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+    const struct wirecost_scenario *scenario = data;
+    send_virtual_desktop_management(client, data, version, id, scenario->count);
+}
+
+void wirecost_server_virtual_desktops(struct wl_display *display, const struct wirecost_scenario *scenario)
+{
+    wl_global_create(display, &org_kde_plasma_virtual_desktop_management_interface, org_kde_plasma_virtual_desktop_management_interface.version,
+                     (void *)scenario, virtual_desktop_management_bind);
+}
@@ -0,0 +1,284 @@
+// SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+// SPDX-License-Identifier: MIT
+
+/*
+ * Drives scripted protocol scenarios between a libwayland client and server
+ * connected through a socketpair, and reports how many messages, bytes, fds and
+ * round-trips each of them needs, as well as the CPU time spent dispatching.
+ * The results are printed as JSON so that protocol changes can be compared.
+ */
+
+#include "wirecost.h"
+
+#include <wayland-client.h>
+#include <wayland-server.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+static const struct wirecost_scenario scenarios[] = {
+    {"window-management-v20", "bind virtual desktop management v4 and window management and fetch all windows, one string event per desktop membership",
+     20, 500, 2, wirecost_server_window_management, wirecost_client_window_management},
+    {"window-management-v22", "bind virtual desktop management v5 and window management and fetch all windows, desktop membership as compact ids",
+     22, 500, 2, wirecost_server_window_management, wirecost_client_window_management},
+    {"output-devices-v23", "announce 4 outputs with 300 modes each", 23, 4, 300, wirecost_server_output_devices, wirecost_client_output_devices},
+    {"output-devices-v25", "announce 4 outputs with 300 modes each, including ICC profile contents", 25, 4, 300, wirecost_server_output_devices,
+     wirecost_client_output_devices},
+    {"virtual-desktops-v4", "bind virtual desktop management and fetch all desktops through per-desktop objects", 4, 16, 0,
+     wirecost_server_virtual_desktops, wirecost_client_virtual_desktops},
+    {"virtual-desktops-v5", "bind virtual desktop management and fetch all desktops from the snapshot", 5, 16, 0, wirecost_server_virtual_desktops,
+     wirecost_client_virtual_desktops},
+};
+
+struct server_thread {
+    struct wl_display *display;
+    struct wirecost_stats *stats;
+    int quit_fd;
+};
+
+static double cpu_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static double wall_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static uint64_t padded(uint64_t size)
+{
+    return (size + 3) & ~(uint64_t)3;
+}
+
+/* Size of a message on the wire: the 8 byte header and the marshalled arguments. */
+static uint64_t message_size(const struct wl_protocol_logger_message *message, uint64_t *fds)
+{
+    uint64_t size = 8;
+    int i = 0;
+    for (const char *signature = message->message->signature; *signature; signature++) {
+        switch (*signature) {
+        case 's':
+            size += 4;
+            if (message->arguments[i].s) {
+                size += padded(strlen(message->arguments[i].s) + 1);
+            }
+            i++;
+            break;
+        case 'a':
+            size += 4;
+            if (message->arguments[i].a) {
+                size += padded(message->arguments[i].a->size);
+            }
+            i++;
+            break;
+        case 'h':
+            (*fds)++;
+            i++;
+            break;
+        case 'i':
+        case 'u':
+        case 'f':
+        case 'o':
+        case 'n':
+            size += 4;
+            i++;
+            break;
+        default:
+            // version number or nullable marker
+            break;
+        }
+    }
+    return size;
+}
+
+static void protocol_logger(void *user_data, enum wl_protocol_logger_type type, const struct wl_protocol_logger_message *message)
+{
+    struct wirecost_stats *stats = user_data;
+    uint64_t size = message_size(message, &stats->fds);
+    if (type == WL_PROTOCOL_LOGGER_REQUEST) {
+        stats->requests++;
+        stats->request_bytes += size;
+    } else {
+        stats->events++;
+        stats->event_bytes += size;
+    }
+}
+
+static int handle_quit(int fd, uint32_t mask, void *data)
+{
+    (void)fd;
+    (void)mask;
+    wl_display_terminate(data);
+    return 0;
+}
+
+static void *run_server(void *data)
+{
+    struct server_thread *server = data;
+    struct wl_event_source *quit = wl_event_loop_add_fd(wl_display_get_event_loop(server->display), server->quit_fd, WL_EVENT_READABLE, handle_quit, server->display);
+    const double start = cpu_time_ms();
+    wl_display_run(server->display);
+    server->stats->server_cpu_ms = cpu_time_ms() - start;
+    wl_event_source_remove(quit);
+    return NULL;
+}
+
+static int run_scenario(const struct wirecost_scenario *scenario, struct wirecost_stats *stats)
+{
+    int result = -1;
+    int sockets[2];
+    int quit[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) < 0) {
+        perror("wirecost");
+        return -1;
+    }
+    if (pipe(quit) < 0) {
+        perror("wirecost");
+        goto err_sockets;
+    }
+
+    struct wl_display *server_display = wl_display_create();
+    if (!server_display) {
+        fprintf(stderr, "wirecost: failed to create the server display\n");
+        goto err_quit;
+    }
+    struct wl_protocol_logger *logger = wl_display_add_protocol_logger(server_display, protocol_logger, stats);
+    scenario->server_setup(server_display, scenario);
+    if (!wl_client_create(server_display, sockets[0])) {
+        fprintf(stderr, "wirecost: failed to create the server side client\n");
+        goto err_server_display;
+    }
+    // the server side client owns its socket now
+    sockets[0] = -1;
+
+    struct server_thread server = {server_display, stats, quit[0]};
+    pthread_t thread;
+    const int thread_error = pthread_create(&thread, NULL, run_server, &server);
+    if (thread_error) {
+        fprintf(stderr, "wirecost: failed to start the server thread: %s\n", strerror(thread_error));
+        goto err_server_display;
+    }
+
+    // the fd is closed by libwayland, also on failure
+    struct wl_display *client_display = wl_display_connect_to_fd(sockets[1]);
+    sockets[1] = -1;
+    if (!client_display) {
+        fprintf(stderr, "wirecost: failed to connect to the server\n");
+        goto err_thread;
+    }
+
+    const double wall_start = wall_time_ms();
+    const double cpu_start = cpu_time_ms();
+    scenario->client_run(client_display, scenario, stats);
+    stats->client_cpu_ms = cpu_time_ms() - cpu_start;
+    stats->wall_ms = wall_time_ms() - wall_start;
+    const int error = wl_display_get_error(client_display);
+    wl_display_disconnect(client_display);
+
+    if (error) {
+        fprintf(stderr, "wirecost: %s failed with a protocol error: %s\n", scenario->name, strerror(error));
+    } else {
+        result = 0;
+    }
+
+err_thread:
+    if (write(quit[1], "q", 1) != 1) {
+        perror("wirecost");
+    }
+    pthread_join(thread, NULL);
+err_server_display:
+    wl_protocol_logger_destroy(logger);
+    wl_display_destroy_clients(server_display);
+    wl_display_destroy(server_display);
+err_quit:
+    close(quit[0]);
+    close(quit[1]);
+err_sockets:
+    if (sockets[0] >= 0) {
+        close(sockets[0]);
+    }
+    if (sockets[1] >= 0) {
+        close(sockets[1]);
+    }
+    return result;
+}
+
+static void print_usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [--quick] [--output FILE] [SCENARIO...]\n\nScenarios:\n", program);
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        fprintf(stderr, "  %-24s %s\n", scenarios[i].name, scenarios[i].description);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int quick = 0;
+    FILE *output = stdout;
+    int first_filter = argc;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = 1;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = fopen(argv[++i], "w");
+            if (!output) {
+                perror("wirecost");
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        } else {
+            first_filter = i;
+            break;
+        }
+    }
+
+    int failed = 0;
+    int printed = 0;
+    fprintf(output, "{\n  \"scenarios\": [");
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        struct wirecost_scenario scenario = scenarios[i];
+        int selected = first_filter == argc;
+        for (int j = first_filter; j < argc; j++) {
+            selected |= strcmp(argv[j], scenario.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        if (quick) {
+            // only check that the scenario works, e.g. when run as a test
+            scenario.count = (scenario.count + 9) / 10;
+            scenario.detail = (scenario.detail + 9) / 10;
+        }
+
+        struct wirecost_stats stats = {0};
+        if (run_scenario(&scenario, &stats) < 0) {
+            failed = 1;
+            continue;
+        }
+        fprintf(output,
+                "%s\n    {\"name\": \"%s\", \"count\": %u, \"detail\": %u, \"messages\": %llu, \"bytes\": %llu, "
+                "\"requests\": %llu, \"request_bytes\": %llu, \"events\": %llu, \"event_bytes\": %llu, \"fds\": %llu, "
+                "\"roundtrips\": %llu, \"client_cpu_ms\": %.3f, \"server_cpu_ms\": %.3f, \"wall_ms\": %.3f}",
+                printed++ ? "," : "", scenario.name, scenario.count, scenario.detail, (unsigned long long)(stats.requests + stats.events),
+                (unsigned long long)(stats.request_bytes + stats.event_bytes), (unsigned long long)stats.requests,
+                (unsigned long long)stats.request_bytes, (unsigned long long)stats.events, (unsigned long long)stats.event_bytes,
+                (unsigned long long)stats.fds, (unsigned long long)stats.roundtrips, stats.client_cpu_ms, stats.server_cpu_ms, stats.wall_ms);
+    }
+    fprintf(output, "\n  ]\n}\n");
+    if (output != stdout) {
+        fclose(output);
+    }
+    return failed;
+}
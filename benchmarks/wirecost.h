@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+
+struct wl_display;
+
+/* What a scenario cost on the wire, as seen by the server. */
+struct wirecost_stats {
+    uint64_t requests;
+    uint64_t request_bytes;
+    uint64_t events;
+    uint64_t event_bytes;
+    uint64_t fds;
+    uint64_t roundtrips;
+    double client_cpu_ms;
+    double server_cpu_ms;
+    double wall_ms;
+};
+
+struct wirecost_scenario {
+    const char *name;
+    const char *description;
+    /* version the client binds the global with */
+    uint32_t version;
+    /* number of windows, outputs or desktops announced */
+    unsigned int count;
+    /* secondary size, e.g. the number of modes per output */
+    unsigned int detail;
+    /* creates the globals on the server display */
+    void (*server_setup)(struct wl_display *display, const struct wirecost_scenario *scenario);
+    /* binds the globals and fetches the complete state */
+    void (*client_run)(struct wl_display *display, const struct wirecost_scenario *scenario, struct wirecost_stats *stats);
+};
+
+void wirecost_server_window_management(struct wl_display *display, const struct wirecost_scenario *scenario);
+void wirecost_server_output_devices(struct wl_display *display, const struct wirecost_scenario *scenario);
+void wirecost_server_virtual_desktops(struct wl_display *display, const struct wirecost_scenario *scenario);
+
+void wirecost_client_window_management(struct wl_display *display, const struct wirecost_scenario *scenario, struct wirecost_stats *stats);
+void wirecost_client_output_devices(struct wl_display *display, const struct wirecost_scenario *scenario, struct wirecost_stats *stats);
+void wirecost_client_virtual_desktops(struct wl_display *display, const struct wirecost_scenario *scenario, struct wirecost_stats *stats);
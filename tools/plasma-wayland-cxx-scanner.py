@@ -0,0 +1,435 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+#
+# SPDX-License-Identifier: MIT
+
+"""
+Generates header-only C++ client bindings for the protocols in this repository.
+
+The bindings are thin templates on top of the code generated by wayland-scanner:
+events are dispatched statically to the derived class (CRTP), so no virtual
+calls or heap allocated wrapper objects are needed, and string and array
+arguments are passed as non-owning views into the wire buffer. Arguments
+referring to an enum of this protocol are passed as the generated enum class;
+enums of other protocols, e.g. wl_output.transform, stay plain integers.
+
+Usage:
+    plasma-wayland-cxx-scanner.py common-header <output>
+    plasma-wayland-cxx-scanner.py client-header <protocol.xml> <output>
+    plasma-wayland-cxx-scanner.py instantiation-test <protocol.xml> <output>
+"""
+
+import os
+import sys
+import xml.etree.ElementTree as ET
+
+NAMESPACE = "PlasmaWaylandProtocols"
+COMMON_HEADER = "plasma-wayland-bindings.h"
+
+CXX_KEYWORDS = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+    "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+    "constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+    "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+    "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+    "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+    "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+    "switch", "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename",
+    "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+}
+
+# Members of the generated classes that request wrappers must not shadow
+RESERVED_MEMBERS = {"init", "object", "version", "interface", "Object", "Request", "Event", "m_object"}
+
+
+def identifier(name, reserved=()):
+    if name[0].isdigit():
+        name = "_" + name
+    if name in CXX_KEYWORDS or name in reserved:
+        name += "_"
+    return name
+
+
+def camel_case(name):
+    return "".join(part[:1].upper() + part[1:] for part in name.split("_") if part)
+
+
+class Arg:
+    def __init__(self, element):
+        self.name = identifier(element.get("name"), ("data",))
+        self.type = element.get("type")
+        self.interface = element.get("interface")
+        self.enum = element.get("enum") if self.type in ("int", "uint") else None
+        # the C++ enum class, set by resolve_enums()
+        self.enum_type = None
+
+    def c_type(self):
+        return {
+            "int": "int32_t",
+            "uint": "uint32_t",
+            "fixed": "wl_fixed_t",
+            "string": "const char *",
+            "array": "struct wl_array *",
+            "fd": "int32_t",
+        }.get(self.type) or "struct %s *" % self.interface
+
+    def cxx_type(self, event):
+        if self.enum_type:
+            return self.enum_type
+        if self.type == "fixed":
+            return "double"
+        if event and self.type == "string":
+            return "std::string_view"
+        if event and self.type == "array":
+            return "ArrayView<uint8_t>"
+        return self.c_type()
+
+    def to_cxx(self):
+        if self.enum_type:
+            return "static_cast<%s>(%s)" % (self.enum_type, self.name)
+        if self.type == "fixed":
+            return "wl_fixed_to_double(%s)" % self.name
+        if self.type in ("string", "array"):
+            return "detail::view(%s)" % self.name
+        return self.name
+
+    def to_c(self):
+        if self.enum_type:
+            return "static_cast<%s>(%s)" % (self.c_type(), self.name)
+        if self.type == "fixed":
+            return "wl_fixed_from_double(%s)" % self.name
+        return self.name
+
+
+class Message:
+    def __init__(self, element):
+        self.name = element.get("name")
+        self.since = int(element.get("since", "1"))
+        self.destructor = element.get("type") == "destructor"
+        self.args = [Arg(arg) for arg in element.findall("arg")]
+        self.new_id = next((arg for arg in self.args if arg.type == "new_id"), None)
+
+
+class Interface:
+    def __init__(self, element):
+        self.name = element.get("name")
+        self.version = int(element.get("version"))
+        self.class_name = camel_case(self.name)
+        self.requests = [Message(request) for request in element.findall("request")]
+        self.events = [Message(event) for event in element.findall("event")]
+        self.enums = element.findall("enum")
+
+    @property
+    def enums_class_name(self):
+        return self.class_name + "Enums"
+
+    def messages(self):
+        return self.requests + self.events
+
+
+def resolve_enums(interfaces):
+    """Sets the enum class of every argument referring to an enum of these interfaces."""
+    by_name = {interface.name: interface for interface in interfaces}
+    for interface in interfaces:
+        for message in interface.messages():
+            for arg in message.args:
+                if not arg.enum:
+                    continue
+                owner, _, enum = arg.enum.rpartition(".")
+                target = by_name.get(owner) if owner else interface
+                if target and enum in (element.get("name") for element in target.enums):
+                    # enums of the own interface are inherited from its enums class
+                    arg.enum_type = camel_case(enum) if target is interface else "%s::%s" % (target.enums_class_name,
+                                                                                              camel_case(enum))
+
+
+def load(path):
+    root = ET.parse(path).getroot()
+    interfaces = [Interface(interface) for interface in root.findall("interface")]
+    resolve_enums(interfaces)
+    return root.get("name"), interfaces
+
+
+def client_header_name(path):
+    return os.path.splitext(os.path.basename(path))[0] + "-client-protocol.h"
+
+
+def bindings_header_name(path):
+    return os.path.splitext(os.path.basename(path))[0] + "-client-bindings.h"
+
+
+def write_common_header(out):
+    out.write("""// SPDX-License-Identifier: MIT
+// Generated by plasma-wayland-cxx-scanner, do not edit.
+
+#pragma once
+
+#include <wayland-util.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace %(ns)s
+{
+
+/**
+ * A non-owning view into a wl_array argument. It is only valid for the duration
+ * of the event handler it was passed to.
+ */
+template<typename T>
+class ArrayView
+{
+public:
+    constexpr ArrayView() = default;
+    constexpr ArrayView(const T *data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    constexpr const T *data() const { return m_data; }
+    constexpr std::size_t size() const { return m_size; }
+    constexpr bool empty() const { return m_size == 0; }
+    constexpr const T *begin() const { return m_data; }
+    constexpr const T *end() const { return m_data + m_size; }
+    constexpr const T &operator[](std::size_t index) const { return m_data[index]; }
+
+    /**
+     * Reinterprets the array as consecutive elements of type U, e.g. the uint32_t
+     * ids of an id list. Trailing bytes that don't form a complete element are ignored.
+     */
+    template<typename U>
+    ArrayView<U> as() const
+    {
+        return ArrayView<U>(reinterpret_cast<const U *>(m_data), m_size * sizeof(T) / sizeof(U));
+    }
+
+private:
+    const T *m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+namespace detail
+{
+inline std::string_view view(const char *string)
+{
+    return string ? std::string_view(string) : std::string_view();
+}
+
+inline ArrayView<uint8_t> view(const struct wl_array *array)
+{
+    return array ? ArrayView<uint8_t>(static_cast<const uint8_t *>(array->data), array->size) : ArrayView<uint8_t>();
+}
+}
+
+}
+""" % {"ns": NAMESPACE})
+
+
+def write_enum(out, interface, enum):
+    name = camel_case(enum.get("name"))
+    out.write("    enum class %s : uint32_t {\n" % name)
+    for entry in enum.findall("entry"):
+        out.write("        %s = %s,\n" % (identifier(entry.get("name")), entry.get("value").strip()))
+    out.write("    };\n")
+    if enum.get("bitfield") == "true":
+        for operator in ("|", "&"):
+            out.write("    friend constexpr %(name)s operator%(op)s(%(name)s a, %(name)s b)\n"
+                      "    {\n"
+                      "        return static_cast<%(name)s>(static_cast<uint32_t>(a) %(op)s static_cast<uint32_t>(b));\n"
+                      "    }\n" % {"name": name, "op": operator})
+    out.write("\n")
+
+
+def write_enums(out, interface):
+    if not interface.enums:
+        return
+    out.write("""/**
+ * The enums of %(name)s. They don't depend on the template argument of
+ * %(class)s, which inherits them, so that other interfaces can refer to them.
+ */
+struct %(enums)s {
+""" % {"name": interface.name, "class": interface.class_name, "enums": interface.enums_class_name})
+    for enum in interface.enums:
+        write_enum(out, interface, enum)
+    out.write("};\n\n")
+
+
+def write_opcodes(out, kind, messages):
+    if not messages:
+        return
+    out.write("    enum class %s : uint32_t {\n" % kind)
+    for opcode, message in enumerate(messages):
+        out.write("        %s = %d,\n" % (identifier(message.name), opcode))
+    out.write("    };\n")
+    out.write("    static constexpr uint32_t %s_since[] = {%s};\n\n"
+              % (kind.lower(), ", ".join(str(message.since) for message in messages)))
+
+
+def write_request(out, interface, request):
+    name = identifier(request.name, RESERVED_MEMBERS)
+    c_function = "%s_%s" % (interface.name, request.name)
+    params = [arg for arg in request.args if arg.type != "new_id"]
+    signature = ", ".join("%s %s" % (arg.cxx_type(False), arg.name) for arg in params)
+    call = ", ".join(["m_object"] + [arg.to_c() for arg in params])
+    result = "struct %s *" % request.new_id.interface if request.new_id else "void "
+    out.write("    %s%s(%s)\n    {\n" % (result, name, signature))
+    if request.new_id:
+        out.write("        return %s(%s);\n" % (c_function, call))
+    else:
+        out.write("        %s(%s);\n" % (c_function, call))
+        if request.destructor:
+            out.write("        m_object = nullptr;\n")
+    out.write("    }\n\n")
+
+
+def write_client_interface(out, interface):
+    ns = {"name": interface.name, "class": interface.class_name, "version": interface.version,
+          "base": " : public %s" % interface.enums_class_name if interface.enums else ""}
+    write_enums(out, interface)
+    out.write("""/**
+ * Client side binding of %(name)s.
+ *
+ * Derive from this template passing the deriving class as template argument and
+ * implement the on_<event> handlers that are needed; the others are no-ops.
+ * Handlers must be accessible from this base class, i.e. public.
+ */
+template<typename Derived>
+class %(class)s%(base)s
+{
+public:
+    using Object = struct %(name)s;
+    static constexpr uint32_t version = %(version)d;
+
+    static const struct wl_interface *interface()
+    {
+        return &%(name)s_interface;
+    }
+
+""" % ns)
+
+    write_opcodes(out, "Request", interface.requests)
+    write_opcodes(out, "Event", interface.events)
+
+    out.write("""    %(class)s() = default;
+    %(class)s(const %(class)s &) = delete;
+    %(class)s &operator=(const %(class)s &) = delete;
+
+    /**
+     * Takes over @p object and dispatches its events to this object, which
+     * therefore must not be moved while the proxy is alive.
+     */
+    void init(Object *object)
+    {
+        m_object = object;
+""" % ns)
+    if interface.events:
+        out.write("        %s_add_listener(object, &s_listener, static_cast<Derived *>(this));\n" % interface.name)
+    out.write("""    }
+
+    Object *object() const
+    {
+        return m_object;
+    }
+
+    explicit operator bool() const
+    {
+        return m_object != nullptr;
+    }
+
+""")
+
+    for request in interface.requests:
+        write_request(out, interface, request)
+    if "destroy" not in (request.name for request in interface.requests):
+        out.write("""    void destroy()
+    {
+        %s_destroy(m_object);
+        m_object = nullptr;
+    }
+
+""" % interface.name)
+
+    if interface.events:
+        out.write("protected:\n")
+        for event in interface.events:
+            params = ", ".join(arg.cxx_type(True) for arg in event.args)
+            out.write("    void on_%s(%s)\n    {\n    }\n" % (event.name, params))
+        out.write("\nprivate:\n")
+        for event in interface.events:
+            params = "".join(", %s%s" % (arg.c_type(), arg.name) if arg.c_type().endswith("*")
+                             else ", %s %s" % (arg.c_type(), arg.name) for arg in event.args)
+            args = ", ".join(arg.to_cxx() for arg in event.args)
+            out.write("""    static void handle_%(event)s(void *data, Object *%(params)s)
+    {
+        static_cast<Derived *>(data)->on_%(event)s(%(args)s);
+    }
+""" % {"event": event.name, "params": params, "args": args})
+        out.write("\n    static constexpr struct %s_listener s_listener = {\n" % interface.name)
+        for event in interface.events:
+            out.write("        &handle_%s,\n" % event.name)
+        out.write("    };\n\n")
+    else:
+        out.write("private:\n")
+    out.write("    Object *m_object = nullptr;\n};\n\n")
+
+
+def write_client_header(out, path):
+    protocol, interfaces = load(path)
+    out.write("""// SPDX-License-Identifier: MIT
+// Generated by plasma-wayland-cxx-scanner from %(file)s, do not edit.
+
+#pragma once
+
+#include "%(common)s"
+#include "%(client)s"
+
+namespace %(ns)s
+{
+namespace Client
+{
+
+""" % {"file": os.path.basename(path), "common": COMMON_HEADER, "client": client_header_name(path), "ns": NAMESPACE})
+    for interface in interfaces:
+        write_client_interface(out, interface)
+    out.write("}\n}\n")
+
+
+def write_instantiation_test(out, path):
+    _, interfaces = load(path)
+    out.write("""// SPDX-License-Identifier: CC0-1.0
+// Generated by plasma-wayland-cxx-scanner from %s, do not edit.
+
+#include "%s"
+
+""" % (os.path.basename(path), bindings_header_name(path)))
+    for interface in interfaces:
+        out.write("struct Test%(class)s : %(ns)s::Client::%(class)s<Test%(class)s> {\n};\n"
+                  "template class %(ns)s::Client::%(class)s<Test%(class)s>;\n\n"
+                  % {"class": interface.class_name, "ns": NAMESPACE})
+    out.write("int main()\n{\n    return 0;\n}\n")
+
+
+def main(argv):
+    if len(argv) == 3 and argv[1] == "common-header":
+        mode, output = argv[1], argv[2]
+        source = None
+    elif len(argv) == 4 and argv[1] in ("client-header", "instantiation-test"):
+        mode, source, output = argv[1:]
+    else:
+        sys.stderr.write(__doc__)
+        return 1
+
+    with open(output, "w", encoding="utf-8") as out:
+        if mode == "common-header":
+            write_common_header(out)
+        elif mode == "client-header":
+            write_client_header(out, source)
+        else:
+            write_instantiation_test(out, source)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,417 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+#
+# SPDX-License-Identifier: MIT
+
+"""
+Records and analyses Wayland protocol traces.
+
+Traces are WAYLAND_DEBUG logs. They are interpreted with the protocols in this
+repository, or any other protocol passed with --protocol, e.g. wayland.xml, to
+know the direction, argument types and destructors of every message. Messages
+of unknown interfaces are still counted, with their size estimated from the
+logged arguments.
+
+report prints per interface and per message histograms of the number of
+messages and bytes, and a hot event report listing the events that were sent
+most often, with their peak rate per frame. convert and record write a
+normalized trace that the tracereplay benchmark replays against a headless
+libwayland-server, so that a recorded session becomes a repeatable benchmark.
+
+Usage:
+    plasma-wayland-trace.py record [options] <output.trace> -- <command>...
+    plasma-wayland-trace.py convert [options] <wayland-debug.log> <output.trace>
+    plasma-wayland-trace.py report [options] [--json] [--top N] <wayland-debug.log or trace>
+
+Options:
+    --server           the log was written by a compositor rather than a client
+    --protocol FILE    additionally load the protocol FILE
+"""
+
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+import xml.etree.ElementTree as ET
+
+TRACE_HEADER = "# plasma-wayland-trace 1"
+PROTOCOLS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "protocols")
+# destructor events of the core protocol, known without passing wayland.xml
+DESTRUCTOR_EVENTS = {"wl_callback.done"}
+# 60 Hz
+FRAME_MS = 1000.0 / 60
+
+# [1234567.890]  -> wl_display@1.get_registry(new id wl_registry@2)
+# [1234567.890] {Default Queue} wl_registry#2.global(1, "wl_compositor", 6)
+LINE = re.compile(r"^\[\s*(?P<time>\d+(?:\.\d+)?)\]\s*(?:\{[^}]*\}\s*)?(?P<discarded>discarded\s+)?(?P<sent>->\s*)?"
+                  r"(?P<interface>[A-Za-z_]\w*)[@#](?P<id>\d+)\.(?P<message>\w+)\((?P<args>.*)\)\s*$")
+OBJECT = re.compile(r"^(?P<interface>\[unknown\]|[A-Za-z_]\w*)[@#](?P<id>\d+)$")
+
+
+def padded(size):
+    return (size + 3) & ~3
+
+
+class Arg:
+    """A logged argument, type is a wayland signature character."""
+
+    def __init__(self, type, value=None, interface=None):
+        self.type = type
+        self.value = value
+        self.interface = interface
+
+    def size(self):
+        if self.type == "h":
+            # passed out of band
+            return 0
+        if self.type == "s":
+            return 4 + (padded(len(self.value.encode("utf-8")) + 1) if self.value is not None else 0)
+        if self.type == "a":
+            return 4 + padded(self.value)
+        return 4
+
+    def normalized(self):
+        if self.type == "s":
+            if self.value is None:
+                return "z"
+            return "s:" + "".join(c if c.isalnum() or c in "_-.:/" else "".join("%%%02X" % b for b in c.encode("utf-8"))
+                                  for c in self.value)
+        if self.type == "n":
+            return "n:%s:%d" % (self.interface, self.value)
+        if self.type == "h":
+            return "h"
+        if self.type == "f":
+            return "f:%s" % self.value
+        return "%s:%d" % (self.type, self.value)
+
+
+class Message:
+    def __init__(self, time, kind, interface, object_id, name, args, destructor):
+        self.time = time
+        # "request" or "event"
+        self.kind = kind
+        self.interface = interface
+        self.object_id = object_id
+        self.name = name
+        self.args = args
+        self.destructor = destructor
+
+    @property
+    def key(self):
+        return "%s.%s" % (self.interface, self.name)
+
+    def size(self):
+        return 8 + sum(arg.size() for arg in self.args)
+
+    def fds(self):
+        return sum(1 for arg in self.args if arg.type == "h")
+
+
+class Protocols:
+    """Signatures of all known messages, by interface and message name."""
+
+    def __init__(self, paths):
+        self.messages = {}
+        for path in paths:
+            root = ET.parse(path).getroot()
+            for interface in root.findall("interface"):
+                for kind in ("request", "event"):
+                    for element in interface.findall(kind):
+                        types = []
+                        for arg in element.findall("arg"):
+                            arg_type = arg.get("type")
+                            if arg_type == "new_id" and not arg.get("interface"):
+                                # untyped new_id is marshalled as interface name, version and id
+                                types += ["s", "u"]
+                            types.append({"int": "i", "uint": "u", "fixed": "f", "string": "s", "object": "o",
+                                          "new_id": "n", "array": "a", "fd": "h"}[arg_type])
+                        self.messages.setdefault((interface.get("name"), element.get("name")), {})[kind] = (
+                            types, element.get("type") == "destructor")
+
+    def known(self, interface):
+        return any(key[0] == interface for key in self.messages)
+
+    def lookup(self, interface, name, kind):
+        kinds = self.messages.get((interface, name), {})
+        if kind in kinds:
+            return kind, kinds[kind]
+        if len(kinds) == 1:
+            return next(iter(kinds.items()))
+        return kind, None
+
+
+def split_args(text):
+    """Splits the logged arguments, strings may contain the separator."""
+    args = []
+    position = 0
+    while position < len(text):
+        if text[position] == '"':
+            end = position + 1
+            while True:
+                end = text.find('"', end)
+                if end < 0 or end + 1 == len(text) or text.startswith(", ", end + 1):
+                    break
+                end += 1
+            if end < 0:
+                end = len(text) - 1
+            args.append(text[position:end + 1])
+            position = end + 1
+        else:
+            end = text.find(", ", position)
+            if end < 0:
+                end = len(text)
+            args.append(text[position:end])
+            position = end
+        if text.startswith(", ", position):
+            position += 2
+    return args
+
+
+def parse_arg(token, expected):
+    if token.startswith('"') and token.endswith('"') and len(token) >= 2:
+        return Arg("s", token[1:-1])
+    if token == "nil":
+        return Arg(expected if expected in ("s", "o") else "o", None if expected == "s" else 0)
+    if token.startswith("new id "):
+        match = OBJECT.match(token[len("new id "):])
+        return Arg("n", int(match.group("id")), match.group("interface"))
+    if token.startswith("fd "):
+        return Arg("h")
+    if token.startswith("array"):
+        size = re.match(r"array(?:\[(\d+)\])?", token).group(1)
+        return Arg("a", int(size) if size else 0)
+    match = OBJECT.match(token)
+    if match:
+        return Arg("o", int(match.group("id")), match.group("interface"))
+    if expected == "f" or (expected is None and "." in token):
+        return Arg("f", float(token))
+    if expected == "i" or (expected is None and token.startswith("-")):
+        return Arg("i", int(token))
+    return Arg("u", int(token))
+
+
+def parse_log(lines, protocols, server, warnings):
+    """Yields the messages of a WAYLAND_DEBUG log, skipping everything else."""
+    for line in lines:
+        match = LINE.match(line.rstrip("\n"))
+        if not match or match.group("discarded"):
+            continue
+        interface, name = match.group("interface"), match.group("message")
+        # clients log the requests they send, compositors the events they send
+        sent = bool(match.group("sent"))
+        kind, signature = protocols.lookup(interface, name, "request" if sent != server else "event")
+        tokens = split_args(match.group("args"))
+        if signature:
+            types, destructor = signature
+        elif kind == "request":
+            types, destructor = None, name in ("destroy", "release")
+        else:
+            types, destructor = None, "%s.%s" % (interface, name) in DESTRUCTOR_EVENTS
+        if types is not None and len(types) != len(tokens):
+            warnings.add("%s.%s has %d arguments in the log but %d in the protocol" % (interface, name, len(tokens), len(types)))
+            types = None
+        args = [parse_arg(token, types[i] if types else None) for i, token in enumerate(tokens)]
+        for i, arg in enumerate(args):
+            if arg.type == "n" and arg.interface == "[unknown]":
+                # untyped new_id, e.g. wl_registry.bind, the interface name precedes it
+                arg.interface = next((previous.value for previous in reversed(args[:i]) if previous.type == "s"), "[unknown]")
+        yield Message(float(match.group("time")), kind, interface, int(match.group("id")), name, args, destructor)
+
+
+def parse_trace(lines):
+    """Yields the messages of a normalized trace."""
+    kinds = {"R": "request", "D": "request", "E": "event", "X": "event"}
+    for line in lines:
+        if line.startswith("#") or not line.strip():
+            continue
+        fields = line.split()
+        args = []
+        for token in fields[5:]:
+            type, _, value = token.partition(":")
+            if type == "z":
+                args.append(Arg("s", None))
+            elif type == "s":
+                args.append(Arg("s", re.sub(r"((?:%[0-9A-F]{2})+)", lambda m: bytes.fromhex(m.group(1).replace("%", "")).decode("utf-8", "replace"), value)))
+            elif type == "n":
+                interface, _, object_id = value.rpartition(":")
+                args.append(Arg("n", int(object_id), interface))
+            elif type == "h":
+                args.append(Arg("h"))
+            elif type == "f":
+                args.append(Arg("f", float(value)))
+            else:
+                args.append(Arg(type, int(value)))
+        yield Message(float(fields[0]), kinds[fields[1]], fields[2], int(fields[3]), fields[4], args, fields[1] in ("D", "X"))
+
+
+def load_messages(path, protocols, server, warnings):
+    with open(path, encoding="utf-8", errors="replace") as trace:
+        first = trace.readline()
+        trace.seek(0)
+        if first.startswith(TRACE_HEADER):
+            return list(parse_trace(trace))
+        return list(parse_log(trace, protocols, server, warnings))
+
+
+def write_trace(messages, out):
+    out.write(TRACE_HEADER + "\n")
+    out.write("# time_ms kind interface object message args...\n")
+    out.write("# kind: R request, D destructor request, E event, X destructor event\n")
+    for message in messages:
+        if message.kind == "event":
+            kind = "X" if message.destructor else "E"
+        else:
+            kind = "D" if message.destructor else "R"
+        out.write(" ".join(["%.3f" % message.time, kind, message.interface, str(message.object_id), message.name]
+                           + [arg.normalized() for arg in message.args]) + "\n")
+
+
+def statistics(messages, protocols, top):
+    interfaces = {}
+    histogram = {}
+    for message in messages:
+        entry = interfaces.setdefault(message.interface, {"requests": 0, "events": 0, "bytes": 0, "fds": 0,
+                                                          "known": protocols.known(message.interface)})
+        entry["requests" if message.kind == "request" else "events"] += 1
+        entry["bytes"] += message.size()
+        entry["fds"] += message.fds()
+        entry = histogram.setdefault((message.key, message.kind), {"count": 0, "bytes": 0, "times": []})
+        entry["count"] += 1
+        entry["bytes"] += message.size()
+        entry["times"].append(message.time)
+
+    hot = []
+    for (key, kind), entry in histogram.items():
+        if kind != "event":
+            continue
+        times = sorted(entry["times"])
+        # most events within one frame and within one second
+        peak_frame = peak_second = 0
+        start_frame = start_second = 0
+        for end, time in enumerate(times):
+            while time - times[start_frame] >= FRAME_MS:
+                start_frame += 1
+            while time - times[start_second] >= 1000:
+                start_second += 1
+            peak_frame = max(peak_frame, end - start_frame + 1)
+            peak_second = max(peak_second, end - start_second + 1)
+        hot.append({"message": key, "count": entry["count"], "bytes": entry["bytes"],
+                    "peak_per_frame": peak_frame, "peak_per_second": peak_second})
+    hot.sort(key=lambda entry: (entry["count"], entry["bytes"]), reverse=True)
+
+    return {
+        "messages": len(messages),
+        "bytes": sum(message.size() for message in messages),
+        "fds": sum(message.fds() for message in messages),
+        "duration_ms": messages[-1].time - messages[0].time if messages else 0,
+        "interfaces": [dict(interface=name, **entry) for name, entry in
+                       sorted(interfaces.items(), key=lambda item: item[1]["bytes"], reverse=True)],
+        "histogram": [{"message": key, "kind": kind, "count": entry["count"], "bytes": entry["bytes"]} for (key, kind), entry in
+                      sorted(histogram.items(), key=lambda item: item[1]["bytes"], reverse=True)],
+        "hot_events": hot[:top],
+    }
+
+
+def bar(value, maximum, width=30):
+    return "#" * max(1, round(width * value / maximum)) if maximum else ""
+
+
+def print_report(stats, out):
+    out.write("%d messages, %d bytes, %d fds in %.1f ms\n\n" % (stats["messages"], stats["bytes"], stats["fds"], stats["duration_ms"]))
+
+    out.write("%-56s %9s %9s %10s %5s\n" % ("interface", "requests", "events", "bytes", "fds"))
+    maximum = max((entry["bytes"] for entry in stats["interfaces"]), default=0)
+    for entry in stats["interfaces"]:
+        name = entry["interface"] + ("" if entry["known"] else " *")
+        out.write("%-56s %9d %9d %10d %5d  %s\n" % (name, entry["requests"], entry["events"], entry["bytes"], entry["fds"],
+                                                   bar(entry["bytes"], maximum)))
+    if not all(entry["known"] for entry in stats["interfaces"]):
+        out.write("* not in the loaded protocols, sizes are estimated from the log\n")
+
+    out.write("\n%-64s %-7s %8s %10s %7s\n" % ("message", "kind", "count", "bytes", "avg"))
+    maximum = max((entry["bytes"] for entry in stats["histogram"]), default=0)
+    for entry in stats["histogram"]:
+        out.write("%-64s %-7s %8d %10d %7.1f  %s\n" % (entry["message"], entry["kind"], entry["count"], entry["bytes"],
+                                                     entry["bytes"] / entry["count"], bar(entry["bytes"], maximum)))
+
+    out.write("\nHot events\n%-64s %8s %10s %10s %10s\n" % ("event", "count", "bytes", "per frame", "per second"))
+    for entry in stats["hot_events"]:
+        out.write("%-64s %8d %10d %10d %10d\n" % (entry["message"], entry["count"], entry["bytes"], entry["peak_per_frame"],
+                                                  entry["peak_per_second"]))
+
+
+def main(argv):
+    args = argv[1:]
+    if "--" in args:
+        index = args.index("--")
+        args, command = args[:index], args[index + 1:]
+    else:
+        command = []
+
+    server = False
+    as_json = False
+    top = 20
+    paths = sorted(glob.glob(os.path.join(PROTOCOLS_DIR, "*.xml")))
+    positional = []
+    i = 0
+    try:
+        while i < len(args):
+            if args[i] == "--server":
+                server = True
+            elif args[i] == "--json":
+                as_json = True
+            elif args[i] == "--protocol":
+                i += 1
+                paths.append(args[i])
+            elif args[i] == "--top":
+                i += 1
+                top = int(args[i])
+            else:
+                positional.append(args[i])
+            i += 1
+    except (IndexError, ValueError):
+        positional = []
+
+    mode = positional[0] if positional else None
+    if not ((mode == "record" and len(positional) == 2 and command) or (mode == "convert" and len(positional) == 3)
+            or (mode == "report" and len(positional) == 2)):
+        sys.stderr.write(__doc__)
+        return 1
+
+    protocols = Protocols(paths)
+    warnings = set()
+    if mode == "record":
+        # the command's own output is passed through, only the protocol log is recorded
+        environment = dict(os.environ, WAYLAND_DEBUG="client")
+        process = subprocess.Popen(command, env=environment, stderr=subprocess.PIPE, text=True, errors="replace")
+        log = []
+        for line in process.stderr:
+            if LINE.match(line):
+                log.append(line)
+            else:
+                sys.stderr.write(line)
+        process.wait()
+        messages = list(parse_log(log, protocols, False, warnings))
+        with open(positional[1], "w", encoding="utf-8") as out:
+            write_trace(messages, out)
+    elif mode == "convert":
+        messages = load_messages(positional[1], protocols, server, warnings)
+        with open(positional[2], "w", encoding="utf-8") as out:
+            write_trace(messages, out)
+    else:
+        stats = statistics(load_messages(positional[1], protocols, server, warnings), protocols, top)
+        if as_json:
+            json.dump(stats, sys.stdout, indent=2)
+            sys.stdout.write("\n")
+        else:
+            print_report(stats, sys.stdout)
+
+    for warning in sorted(warnings):
+        sys.stderr.write("warning: %s\n" % warning)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2026 Plasma Wayland Protocols contributors
+#
+# SPDX-License-Identifier: MIT
+
+"""
+Computes the size on the wire of every request and event of the given protocols.
+
+The report lists, per message, the size of its fixed part, a typical size
+estimated from common argument lengths, and the worst case. Strings and arrays
+are unbounded: a single message can't be larger than libwayland's connection
+buffer, and getting close to that stalls or kills the connection. Messages that
+are sent frequently or that are typically large are flagged.
+
+The check fails if a message added in a later version carries an unbounded
+string or array without an fd alternative, i.e. a message of the same
+interface and direction passing the payload through a file descriptor. The
+alternatives are listed explicitly in FD_ALTERNATIVES (e.g. icc_profile_path
+and icc_profile_content), so that unrelated messages don't exempt each other.
+A message is added in the later of its since version and the version in which
+its interface first appears, i.e. the since version of the first message
+creating objects of it, so that the messages of an interface introduced in a
+later version are checked as well. Known exceptions are listed in the baseline
+file, one interface.message per line.
+
+Usage:
+    plasma-wayland-wire-size.py report <protocol.xml>...
+    plasma-wayland-wire-size.py check --baseline <file> <protocol.xml>...
+    plasma-wayland-wire-size.py baseline <protocol.xml>...
+"""
+
+import os
+import sys
+import xml.etree.ElementTree as ET
+
+HEADER_SIZE = 8
+# libwayland's connection buffer, larger messages can't be sent at all
+MAX_MESSAGE_SIZE = 4096
+# messages whose typical size exceeds this are flagged as large
+LARGE_MESSAGE_SIZE = 256
+
+# Messages that are sent many times per second or for every window, and thus
+# should be small and not carry unbounded payloads
+HOT_MESSAGES = {
+    "org_kde_plasma_window.title_changed",
+    "org_kde_plasma_window.state_changed",
+    "org_kde_plasma_window.geometry",
+    "org_kde_plasma_window.client_geometry",
+    "org_kde_plasma_window_management.stacking_order_changed",
+    "org_kde_plasma_window_management.stacking_order_uuid_changed",
+    "org_kde_plasma_window_management.stacking_order_changed_2",
+    "org_kde_kwin_fake_input.pointer_motion",
+    "org_kde_kwin_fake_input.pointer_motion_absolute",
+    "org_kde_kwin_fake_input.axis",
+    "org_kde_kwin_fake_input.touch_motion",
+    "zwp_text_input_v2.set_surrounding_text",
+    "zwp_text_input_v2.insert_surrounding_text",
+    "zwp_text_input_v2.delete_surrounding_text_range",
+    "zwp_text_input_v2.set_cursor_rectangle",
+    "zwp_text_input_v2.preedit_string",
+    "zwp_text_input_v2.preedit_styling",
+    "zwp_text_input_v2.preedit_styling_array",
+    "zwp_text_input_v2.commit_string",
+    "wl_text_input.set_surrounding_text",
+    "wl_text_input.preedit_string",
+    "wl_text_input.commit_string",
+}
+
+# Messages carrying an unbounded payload that can also be passed through a file
+# descriptor, mapped to the message of the same interface and direction doing so
+FD_ALTERNATIVES = {
+    "kde_output_device_v2.icc_profile_path": "kde_output_device_v2.icc_profile_content",
+    "kde_output_device_v2.hdr_icc_profile_path": "kde_output_device_v2.icc_profile_content",
+    "org_kde_plasma_window.application_menu": "org_kde_plasma_window.application_menu_layout",
+}
+
+# Typical string lengths including the terminating NUL, by the message and
+# argument name, the first match wins
+TYPICAL_STRING_SIZES = [
+    ("edid", 345),  # a 256 byte EDID, base64 encoded
+    ("uuid", 39),
+    ("path", 64),
+    ("title", 48),
+    ("text", 64),
+    ("palette", 64),
+    ("address", 40),
+    ("description", 48),
+    ("reason", 48),
+    ("id", 37),
+    ("name", 16),
+]
+DEFAULT_STRING_SIZE = 24
+DEFAULT_ARRAY_SIZE = 16
+
+
+def padded(size):
+    return (size + 3) & ~3
+
+
+def typical_string_size(name):
+    name = name.lower()
+    for key, size in TYPICAL_STRING_SIZES:
+        if key in name:
+            return size
+    return DEFAULT_STRING_SIZE
+
+
+class Message:
+    def __init__(self, interface, kind, element):
+        self.interface = interface
+        self.kind = kind
+        self.name = element.get("name")
+        self.since = int(element.get("since", "1"))
+        # the version the message was added in, including that of its interface, set by load()
+        self.added = self.since
+        self.args = element.findall("arg")
+        self.creates = {arg.get("interface") for arg in self.args if arg.get("type") == "new_id" and arg.get("interface")}
+        self.fixed = HEADER_SIZE
+        self.typical = HEADER_SIZE
+        self.fds = 0
+        self.unbounded = []
+        for arg in self.args:
+            arg_type = arg.get("type")
+            if arg_type == "fd":
+                # passed out of band
+                self.fds += 1
+            elif arg_type in ("string", "array"):
+                self.fixed += 4
+                self.typical += 4
+                if arg_type == "string":
+                    self.typical += padded(typical_string_size("%s_%s" % (self.name, arg.get("name"))))
+                else:
+                    self.typical += DEFAULT_ARRAY_SIZE
+                self.unbounded.append(arg.get("name"))
+            else:
+                self.fixed += 4
+                self.typical += 4
+
+    @property
+    def key(self):
+        return "%s.%s" % (self.interface, self.name)
+
+    def worst(self):
+        return "unbounded" if self.unbounded else str(self.fixed)
+
+    def flags(self):
+        flags = []
+        if self.key in HOT_MESSAGES:
+            flags.append("hot")
+        if self.typical > LARGE_MESSAGE_SIZE:
+            flags.append("large")
+        return flags
+
+
+def interface_versions(messages):
+    """Returns the version every interface first appears in, 1 for globals."""
+    created = {interface for message in messages for interface in message.creates}
+    versions = {message.interface: 1 for message in messages if message.interface not in created}
+    # an interface with messages added before the version it is first created in
+    # existed before, as a global, e.g. kde_output_device_v2 before its registry
+    first_since = {}
+    for message in messages:
+        if message.since > 1:
+            first_since[message.interface] = min(message.since, first_since.get(message.interface, sys.maxsize))
+    # objects inherit the version of the object creating them, so propagate until nothing changes
+    changed = True
+    while changed:
+        changed = False
+        for message in messages:
+            if message.interface not in versions:
+                continue
+            version = max(message.since, versions[message.interface])
+            for interface in message.creates:
+                if first_since.get(interface, sys.maxsize) < version:
+                    version = 1
+                if version < versions.get(interface, sys.maxsize):
+                    versions[interface] = version
+                    changed = True
+    return versions
+
+
+def load(paths):
+    messages = []
+    for path in paths:
+        root = ET.parse(path).getroot()
+        for interface in root.findall("interface"):
+            for kind in ("request", "event"):
+                messages += [Message(interface.get("name"), kind, element) for element in interface.findall(kind)]
+    versions = interface_versions(messages)
+    for message in messages:
+        message.added = max(message.since, versions.get(message.interface, 1))
+    return messages
+
+
+def has_fd_alternative(message, messages):
+    if message.fds:
+        return True
+    alternative = FD_ALTERNATIVES.get(message.key)
+    return any(other.key == alternative and other.kind == message.kind and other.fds for other in messages)
+
+
+def violations(messages):
+    return [message for message in messages
+            if message.added > 1 and message.unbounded and not has_fd_alternative(message, messages)]
+
+
+def report(messages, out):
+    out.write("%-72s %-7s %5s %5s %5s %7s %9s %3s  %s\n"
+              % ("message", "kind", "since", "added", "fixed", "typical", "worst", "fds", "flags"))
+    for message in messages:
+        out.write("%-72s %-7s %5d %5d %5d %7d %9s %3d  %s\n"
+                  % (message.key, message.kind, message.since, message.added, message.fixed, message.typical,
+                     message.worst(), message.fds, ",".join(message.flags())))
+
+
+def read_baseline(path):
+    with open(path, encoding="utf-8") as baseline:
+        return {line.strip() for line in baseline if line.strip() and not line.startswith("#")}
+
+
+def check(messages, baseline, out):
+    ok = True
+    for message in messages:
+        if message.key in HOT_MESSAGES and message.unbounded:
+            out.write("warning: %s is sent frequently and carries unbounded %s, at most %d bytes fit into a message\n"
+                      % (message.key, ", ".join(message.unbounded), MAX_MESSAGE_SIZE - message.fixed))
+        elif "large" in message.flags():
+            out.write("warning: %s is typically %d bytes large\n" % (message.key, message.typical))
+    for message in violations(messages):
+        if message.key in baseline:
+            continue
+        out.write("error: %s was added in version %d and carries unbounded %s without an fd alternative\n"
+                  % (message.key, message.added, ", ".join(message.unbounded)))
+        ok = False
+    return ok
+
+
+def main(argv):
+    if len(argv) >= 3 and argv[1] in ("report", "baseline"):
+        mode, paths, baseline = argv[1], argv[2:], None
+    elif len(argv) >= 5 and argv[1] == "check" and argv[2] == "--baseline":
+        mode, paths, baseline = argv[1], argv[4:], argv[3]
+    else:
+        sys.stderr.write(__doc__)
+        return 1
+
+    messages = load(paths)
+    if mode == "report":
+        report(messages, sys.stdout)
+    elif mode == "baseline":
+        sys.stdout.write("# SPDX-License-Identifier: CC0-1.0\n"
+                         "# Generated by %s baseline\n"
+                         "# Messages added in a later version that carry unbounded payloads without an fd alternative\n"
+                         % os.path.basename(argv[0]))
+        for message in violations(messages):
+            sys.stdout.write(message.key + "\n")
+    elif not check(messages, read_baseline(baseline), sys.stdout):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))